@@ -19,9 +19,11 @@
 #include <cassert>
 #include <cctype>
 #include <climits>
+#include <cmath>
 #include <list>
 #include <queue>
 #include <algorithm>
+#include <random>
 #include "defs.hh"
 #include "bc.hh"
 #include "timer.hh"
@@ -1154,6 +1156,191 @@ BC::compute_stats(unsigned int &max_min_height, unsigned int &max_max_height)
 }
 
 
+void
+BC::compute_branching_hints(const unsigned int nof_vars,
+			    std::vector<double>& activity,
+			    std::vector<bool>& phase,
+			    const unsigned int seed,
+			    std::vector<bool>* const sim_phase)
+{
+  const unsigned int N = index_to_gate.size();
+  const unsigned int far = UINT_MAX;
+
+  activity.assign(nof_vars, 0.0);
+  phase.assign(nof_vars, false);
+  if(sim_phase)
+    sim_phase->assign(nof_vars, false);
+
+  std::vector<Gate*>* const ordering = get_top_down_ordering();
+  const unsigned int nof_gates = ordering->size();
+
+  /*
+   * Top-down: count the paths from each gate up to the gates in its
+   * fan-out cone (the path count of a gate is the sum, over its parents,
+   * of one plus the path count of the parent; this over-approximates
+   * the fan-out cone size when the cone has shared gates) and
+   * compute the distances to the constrained gates
+   */
+  std::vector<double> paths(N, 0.0);
+  std::vector<unsigned int> distance(N, far);
+  for(unsigned int i = 0; i < nof_gates; i++)
+    {
+      Gate* const gate = (*ordering)[i];
+      if(gate->determined and !gate->is_justified())
+	distance[gate->index] = 0;
+      for(const ChildAssoc* ca = gate->children; ca; ca = ca->next_child)
+	{
+	  const unsigned int ci = ca->child->index;
+	  paths[ci] += 1.0 + paths[gate->index];
+	  if(paths[ci] > 1e100)
+	    paths[ci] = 1e100;
+	  if(distance[gate->index] != far and
+	     distance[gate->index] + 1 < distance[ci])
+	    distance[ci] = distance[gate->index] + 1;
+	}
+    }
+
+  /*
+   * Bottom-up: compute the levels and simulate the circuit with
+   * 32 random input vectors in parallel
+   */
+  std::vector<unsigned int> level(N, 0);
+  std::vector<unsigned int> values(N, 0);
+  /* A local generator: the hints may be computed in several threads */
+  std::mt19937 rng(seed);
+  for(unsigned int i = nof_gates; i-- > 0; )
+    {
+      Gate* const gate = (*ordering)[i];
+      for(const ChildAssoc* ca = gate->children; ca; ca = ca->next_child)
+	if(level[ca->child->index] + 1 > level[gate->index])
+	  level[gate->index] = level[ca->child->index] + 1;
+      if(gate->type == Gate::tVAR)
+	{
+	  if(gate->determined)
+	    values[gate->index] = gate->value?~0u:0;
+	  else
+	    values[gate->index] = (unsigned int)rng();
+	}
+      else
+	values[gate->index] = gate->simulate(values);
+    }
+
+  /* Find the simulation satisfying most of the constrained gates */
+  unsigned int nof_satisfied[32];
+  for(unsigned int bit = 0; bit < 32; bit++)
+    nof_satisfied[bit] = 0;
+  for(unsigned int i = 0; i < nof_gates; i++)
+    {
+      Gate* const gate = (*ordering)[i];
+      if(!gate->determined or gate->temp <= 0)
+	continue;
+      const unsigned int ok = values[gate->index] ^ (gate->value?0:~0u);
+      for(unsigned int bit = 0; bit < 32; bit++)
+	nof_satisfied[bit] += (ok >> bit) & 1;
+    }
+  unsigned int best = 0;
+  for(unsigned int bit = 1; bit < 32; bit++)
+    if(nof_satisfied[bit] > nof_satisfied[best])
+      best = bit;
+
+  /*
+   * The phase is the value in the best simulation, unless the polarity
+   * information says that only one of the values is ever needed.
+   * Activities grow with the fan-out path count and
+   * decrease with the level and the distance to the constrained gates.
+   */
+  mir_compute_polarity_information();
+  unsigned int max_distance = 0;
+  for(unsigned int i = 0; i < nof_gates; i++)
+    {
+      const unsigned int d = distance[(*ordering)[i]->index];
+      if(d != far and d > max_distance)
+	max_distance = d;
+    }
+  double max_score = 0.0;
+  for(unsigned int i = 0; i < nof_gates; i++)
+    {
+      Gate* const gate = (*ordering)[i];
+      if(gate->temp <= 0 or (unsigned int)gate->temp >= nof_vars)
+	continue;
+      const unsigned int d = (distance[gate->index] == far)?
+	max_distance + 1 : distance[gate->index];
+      const double score =
+	log2(2.0 + paths[gate->index]) /
+	((1.0 + log2(1.0 + level[gate->index])) * (1.0 + log2(1.0 + d)));
+      activity[gate->temp] = score;
+      if(score > max_score)
+	max_score = score;
+      if(sim_phase)
+	(*sim_phase)[gate->temp] = (values[gate->index] >> best) & 1;
+      if(gate->mir_pos and !gate->mir_neg)
+	phase[gate->temp] = true;
+      else if(gate->mir_neg and !gate->mir_pos)
+	phase[gate->temp] = false;
+      else
+	phase[gate->temp] = (values[gate->index] >> best) & 1;
+    }
+  if(max_score > 0.0)
+    for(unsigned int v = 0; v < nof_vars; v++)
+      activity[v] /= max_score;
+
+  delete ordering;
+}
+
+
+
+/*
+ * Mix the 64-bit value x into the hash h (with the splitmix64 finalizer)
+ */
+static uint64_t
+structural_key_mix(uint64_t h, const uint64_t x)
+{
+  h ^= x + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+  return h ^ (h >> 31);
+}
+
+void
+BC::compute_structural_keys(std::vector<uint64_t>& keys) const
+{
+  keys.assign(index_to_gate.size(), 0);
+  std::vector<Gate*>* const ordering = get_bottom_up_ordering();
+  std::vector<uint64_t> child_keys;
+  for(unsigned int i = 0; i < ordering->size(); i++)
+    {
+      const Gate* const gate = (*ordering)[i];
+      uint64_t key = structural_key_mix(0, gate->type);
+      if(gate->type == Gate::tVAR)
+	{
+	  /* FNV-1a of the name */
+	  const char* const name = gate->get_first_name();
+	  uint64_t h = 0xCBF29CE484222325ULL;
+	  for(const char* p = name ? name : ""; *p; p++)
+	    h = (h ^ (unsigned char)*p) * 0x100000001B3ULL;
+	  keys[gate->index] = structural_key_mix(key, h);
+	  continue;
+	}
+      if(gate->type == Gate::tTHRESHOLD or gate->type == Gate::tATLEAST)
+	{
+	  key = structural_key_mix(key, gate->tmin);
+	  key = structural_key_mix(key, gate->tmax);
+	}
+      child_keys.clear();
+      for(const ChildAssoc* ca = gate->children; ca; ca = ca->next_child)
+	child_keys.push_back(keys[ca->child->index]);
+      if(!(gate->type == Gate::tITE or gate->type == Gate::tNOT or
+	   gate->type == Gate::tREF))
+	std::sort(child_keys.begin(), child_keys.end());
+      for(unsigned int j = 0; j < child_keys.size(); j++)
+	key = structural_key_mix(key, child_keys[j]);
+      keys[gate->index] = key;
+    }
+  delete ordering;
+}
+
+
+
 void
 BC::compute_size(unsigned int &nof_gates, unsigned int &nof_edges)
 {
@@ -1220,7 +1407,7 @@ BC::remove_deleted_gates(unsigned int &removed, unsigned int &remaining)
  **************************************************************************/
 
 bool
-BC::cnf_normalize()
+BC::cnf_normalize(const bool native_cardinality)
 {
   unsigned int nof_gates, nof_removed;
 
@@ -1244,7 +1431,7 @@ BC::cnf_normalize()
       gate->in_pstack = false;
       pstack = gate->pstack_next;
       gate->pstack_next = 0;
-      if(!gate->cnf_normalize(this))
+      if(!gate->cnf_normalize(this, native_cardinality))
 	return false;
     }
   
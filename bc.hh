@@ -20,10 +20,14 @@
 
 class BC;
 class SimplifyOptions;
+class Objective;
 
 #include <cstdio>
+#include <stdint.h>
 #include <list>
 #include <map>
+#include <string>
+#include <vector>
 #include "defs.hh"
 #include "gate.hh"
 #include "handle.hh"
@@ -259,7 +263,8 @@ public:
 		   const bool notless,
 		   const bool input_cuts_only,
 		   const bool permute_cnf,
-		   const unsigned int permute_cnf_seed);
+		   const unsigned int permute_cnf_seed,
+		   const unsigned int mem_limit_mb);
   
   /*
    * Returns
@@ -267,6 +272,40 @@ public:
    *   1 if sat
    * May transform the structure of the circuit
    * The circuit is left in an unclear state at the moment
+   * If \a objective is non-null, a solution optimal w.r.t. it is searched
+   * and its value is stored in objective->value.
+   * If \a checkpoint_file is non-null, the solver state is written to it
+   * every \a checkpoint_interval CPU seconds (see minisat_resume()).
+   * If \a lemma_cache is non-null, the lemmas in that file that are implied
+   * by the CNF are added before solving and, at the end, the short learnt
+   * clauses over named gates are written back to it
+   * (at most \a lemma_cache_size of them).
+   * If \a proof_file is non-null, a binary DRAT proof is written to it and
+   * the CNF it refers to is written to \a proof_cnf_file; this requires
+   * that \a native_xor, \a native_cardinality, \a objective,
+   * \a checkpoint_file and \a lemma_cache are not used.
+   * No proof is written if the circuit is found unsatisfiable before
+   * the CNF translation.
+   * If \a component_threads is positive, the independent components of
+   * the relevant circuit are solved with separate solvers in that many
+   * threads; this cannot be combined with the options above.
+   * If \a symmetry_breaking is true, add_symmetry_breaking() is applied
+   * to the simplified circuit; this cannot be combined with \a objective.
+   * If \a vmtf is true, MiniSat decides by a variable move-to-front queue
+   * instead of the VSIDS activity heap.
+   * If \a tiered_reduce is true, MiniSat keeps its learnt clauses in tiers
+   * by their literal block distance instead of halving them by activity.
+   * If \a stable_mode is true, MiniSat alternates between a focused and
+   * a stable search mode and periodically resets its phases (rephasing).
+   * If \a chrono_backtrack is non-negative, MiniSat backtracks only one
+   * level when a backjump would undo more levels than that.
+   * If \a reuse_trail is true, MiniSat restarts keep the decisions that
+   * would be made again in the same order.
+   * If \a inprocess_frac is positive, MiniSat vivifies learnt clauses and
+   * probes failed literals between restarts, spending at most that
+   * fraction of the search propagations on it.
+   * The subsumption checks of the MiniSat preprocessing are run in
+   * \a simp_threads threads.
    */
   int minisat_solve(const bool perform_simplifications,
 		    const SimplifyOptions& opts,
@@ -274,9 +313,43 @@ public:
 		    const bool notless,
 		    const bool input_cuts_only,
 		    const bool permute_cnf,
-		    const unsigned int permute_cnf_seed
+		    const unsigned int permute_cnf_seed,
+		    const bool structural_hints,
+		    const bool native_xor,
+		    const bool native_cardinality,
+		    Objective* const objective,
+		    const char* const checkpoint_file,
+		    const double checkpoint_interval,
+		    const char* const lemma_cache,
+		    const unsigned int lemma_cache_size,
+		    const char* const proof_file,
+		    const char* const proof_cnf_file,
+		    const unsigned int component_threads,
+		    const bool symmetry_breaking,
+		    const bool vmtf,
+		    const bool tiered_reduce,
+		    const bool stable_mode,
+		    const int chrono_backtrack,
+		    const bool reuse_trail,
+		    const double inprocess_frac,
+		    const unsigned int simp_threads
 		    );
 
+  /**
+   * Continue a minisat_solve() run from a checkpoint written by it,
+   * without the circuit.
+   * If \a checkpoint_file is non-null, new checkpoints are written to it.
+   * Returns
+   *   -1 if the checkpoint cannot be read
+   *   0 if unsat
+   *   1 if sat, \a assignment then gets the values of the named gates that
+   *     were relevant for the CNF, constant, or input gates
+   */
+  static int minisat_resume(const char* const resume_file,
+			    const char* const checkpoint_file,
+			    const double checkpoint_interval,
+			    std::list<std::pair<std::string, bool> >& assignment);
+
 
 
 
@@ -441,13 +514,64 @@ public:
   void compute_stats(unsigned int &max_min_height,
 		     unsigned int &max_max_height);
 
+  /**
+   * Compute structure-derived branching hints for the gates that
+   * have been numbered in their temp fields as done in the CNF translations.
+   * For each such gate g, \a activity[g->temp] is set to a value in [0,1]
+   * that grows with the number of paths from g up to the gates in its
+   * fan-out cone (an over-approximation of the fan-out cone size when
+   * the cone has shared gates; the fan-in cone of g is not used) and
+   * decreases with the level of g and its distance to the constrained gates.
+   * The value \a phase[g->temp] is the value preferred by the polarity
+   * information when only one value of g is needed, and otherwise
+   * the value of g in the best of 32 bit-parallel random simulations;
+   * their inputs come from a local generator seeded with \a seed,
+   * the global rand() state is not used.
+   * If \a sim_phase is non-null, \a (*sim_phase)[g->temp] is set to
+   * the value of g in the best simulation regardless of the polarities.
+   * The circuit should have been normalized with cnf_normalize().
+   * WARNING: recomputes the polarity information of the gates.
+   */
+  void compute_branching_hints(const unsigned int nof_vars,
+			       std::vector<double>& activity,
+			       std::vector<bool>& phase,
+			       const unsigned int seed = 0,
+			       std::vector<bool>* const sim_phase = 0);
+
+  /**
+   * Compute a 64-bit structural key \a keys[g->index] for each gate g.
+   * The key of an input gate depends only on its name and the key of
+   * other gates on the type, the threshold bounds and the keys of the
+   * children (in order only for ITE, NOT and REF gates).
+   * Thus the key of a gate does not change between circuit revisions
+   * in which its fan-in cone stays the same.
+   */
+  void compute_structural_keys(std::vector<uint64_t>& keys) const;
+
+  /**
+   * Search the circuit for symmetries, i.e. permutations of the gates
+   * that preserve the gate types, values, threshold bounds and
+   * (ordered for ITE gates) children, and add lex-leader
+   * symmetry-breaking constraints over the inputs for at most
+   * \a max_generators of the generators found.
+   * The constraints are new constrained gates, so the circuit stays
+   * satisfiable iff it was.
+   * Does nothing if \a preserve_all_solutions is set.
+   * @return false if an inconsistency was found (implying that the circuit
+   *               is unsatisfiable).
+   */
+  bool add_symmetry_breaking(unsigned int& nof_generators,
+			     const unsigned int max_generators = 64);
+
   /**
    * Transform the circuit into a form that can be translated into CNF:
    * Remove double negations and ref-gates,
    * translate threshold gates into normal gates,
    * and explode n-ary equivs, odds and evens.
+   * If \a native_cardinality is true, ATLEAST-gates are not translated
+   * but left for a solver that handles cardinality constraints.
    */
-  bool cnf_normalize();
+  bool cnf_normalize(const bool native_cardinality = false);
 
   /**
    * Transform the circuit into a form that can be translated into edimacs:
@@ -553,4 +677,27 @@ public:
 };
 
 
+/**
+ * \brief An objective for BC::minisat_solve():
+ * minimize (or maximize) the weighted number of true gates.
+ */
+class Objective {
+public:
+  Objective() {
+    maximize = false;
+    strategy = LINEAR_SAT_UNSAT;
+    value = 0;
+  }
+  typedef enum {LINEAR_SAT_UNSAT = 0, CORE_GUIDED} Strategy;
+  bool maximize;
+  Strategy strategy;
+  /** The objective gates; handles so that they survive simplification. */
+  std::vector<Handle*> gates;
+  /** The positive weights of the objective gates. */
+  std::vector<unsigned int> weights;
+  /** The value of the optimal solution found. */
+  unsigned long value;
+};
+
+
 #endif
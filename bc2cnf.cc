@@ -18,6 +18,10 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdarg>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
 #include "defs.hh"
 #include "bc.hh"
 
@@ -38,6 +42,9 @@ static bool opt_perform_simplifications = true;
 static bool opt_preserve_all_solutions = false;
 static bool opt_print_input_gates = false;
 static bool opt_output_xcnf = false;
+static const char *opt_varmap_file = 0;
+static bool opt_delta = false;
+static bool opt_symmetry = false;
 static SimplifyOptions simplify_opts;
 
 static void
@@ -64,6 +71,16 @@ usage(FILE* const fp, const char* argv0)
 "  -polarity_cnf   use polarity exploiting CNF translation\n"
 "  -permute_cnf=s  permute CNF variables with seed s\n"
 "  -xcnf           output xcnf (dimacs CNF with xor clauses)\n"
+"  -varmap=f       number the CNF variables by the structural keys of the\n"
+"                  gates stored in the file f (created if missing), so that\n"
+"                  unchanged gates keep their variables across revisions;\n"
+"                  the file is updated with the new gates\n"
+"  -delta          with -varmap, only output the clauses of the gates whose\n"
+"                  translation is new or changed since the map was written;\n"
+"                  retired translations are listed in \"c removed <var>\"\n"
+"                  comments\n"
+"  -symmetry       add lex-leader constraints breaking the symmetries of\n"
+"                  the circuit (ignored with -all)\n"
 "  -print_inputs   print input gate names\n"
 "  <circuit file>  input circuit file (if not specified, stdin is used)\n"
 "  <cnf file>      output cnf file (if not specified, stdout is used)\n"
@@ -97,6 +114,12 @@ parse_options(const int argc, const char** argv)
       opt_cnf_notless = false;
     else if(strcmp(argv[i], "-xcnf") == 0)
       opt_output_xcnf = true;
+    else if(strncmp(argv[i], "-varmap=", 8) == 0)
+      opt_varmap_file = argv[i] + 8;
+    else if(strcmp(argv[i], "-delta") == 0)
+      opt_delta = true;
+    else if(strcmp(argv[i], "-symmetry") == 0)
+      opt_symmetry = true;
     else if(strcmp(argv[i], "-print_inputs") == 0)
       opt_print_input_gates = true;
     else if(argv[i][0] == '-') {
@@ -126,13 +149,120 @@ parse_options(const int argc, const char** argv)
       }
     }
   }
+  if(opt_delta and !opt_varmap_file) {
+    fprintf(stderr, "-delta requires -varmap\n");
+    exit(1);
+  }
+  if(opt_varmap_file and opt_cnf_permute) {
+    fprintf(stderr, "-varmap and -permute_cnf cannot be used together\n");
+    exit(1);
+  }
+}
+
+
+
+/*
+ * The persistent variable map: for the structural key of each gate
+ * translated so far, its CNF variable, the signature of its clauses,
+ * and whether it was translated in the latest run.
+ * Stored as text lines "<key> <signature> <variable> <present>".
+ */
+class VarMapEntry {
+public:
+  int var;
+  uint64_t signature;
+  bool present;
+};
+typedef std::map<uint64_t, VarMapEntry> VarMap;
+
+static uint64_t
+mix64(uint64_t h, const uint64_t x)
+{
+  h ^= x + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+  return h ^ (h >> 31);
+}
+
+/*
+ * An order-independent signature of a clause, \a tag distinguishes
+ * xor-clauses from ordinary ones
+ */
+static uint64_t
+clause_signature(std::vector<int> clause, const int tag)
+{
+  std::sort(clause.begin(), clause.end());
+  uint64_t h = mix64(0, tag);
+  for(unsigned int i = 0; i < clause.size(); i++)
+    h = mix64(h, (uint64_t)(int64_t)clause[i]);
+  return h;
+}
+
+static void
+read_varmap(const char* const file, VarMap& varmap)
+{
+  FILE* const fp = fopen(file, "r");
+  if(!fp)
+    {
+      verbose_print("The variable map %s does not exist yet\n", file);
+      return;
+    }
+  char line[256];
+  while(fgets(line, sizeof(line), fp))
+    {
+      unsigned long long key, signature;
+      int var, present;
+      /* Comment lines start with "c " (keys are hexadecimal) */
+      if(line[0] == 'c' and line[1] == ' ')
+	continue;
+      if(sscanf(line, "%llx %llx %d %d", &key, &signature, &var, &present) != 4
+	 or var <= 0)
+	{
+	  fprintf(stderr, "malformed line in the variable map `%s'\n", file);
+	  exit(1);
+	}
+      VarMapEntry& entry = varmap[key];
+      entry.var = var;
+      entry.signature = signature;
+      entry.present = (present != 0);
+    }
+  fclose(fp);
+}
+
+static void
+write_varmap(const char* const file, const VarMap& varmap)
+{
+  const std::string tmp_file = std::string(file) + ".tmp";
+  FILE* const fp = fopen(tmp_file.c_str(), "w");
+  if(!fp)
+    {
+      fprintf(stderr, "cannot open `%s' for output\n", tmp_file.c_str());
+      exit(1);
+    }
+  fprintf(fp, "c bc2cnf variable map: key signature variable present\n");
+  for(VarMap::const_iterator it = varmap.begin(); it != varmap.end(); it++)
+    fprintf(fp, "%016llx %016llx %d %d\n",
+	    (unsigned long long)it->first,
+	    (unsigned long long)it->second.signature,
+	    it->second.var, it->second.present ? 1 : 0);
+  if(fclose(fp) != 0 or rename(tmp_file.c_str(), file) != 0)
+    {
+      fprintf(stderr, "cannot write the variable map `%s'\n", file);
+      exit(1);
+    }
 }
 
+
+
 int
 main(const int argc, const char** argv)
 {
   BC *circuit = 0;
   int max_var_num;
+  VarMap varmap;
+  std::vector<uint64_t> keys;
+  std::vector<uint64_t> signatures;
+  std::vector<bool> changed;
 
   verbstr = stdout;
 
@@ -202,7 +332,14 @@ main(const int argc, const char** argv)
 	goto unsat_exit;
     }
 
-
+  if(opt_symmetry)
+    {
+      unsigned int nof_generators = 0;
+      if(!circuit->add_symmetry_breaking(nof_generators))
+	goto unsat_exit;
+      verbose_print("Added symmetry-breaking constraints for %u generators\n",
+		    nof_generators);
+    }
 
 
   if(!circuit->cnf_normalize())
@@ -256,6 +393,18 @@ main(const int argc, const char** argv)
   }
   
 
+  /*
+   * With a variable map, the variables of the gates are taken from the map
+   * by the structural keys of the gates (made unique by rehashing)
+   */
+  if(opt_varmap_file)
+    {
+      read_varmap(opt_varmap_file, varmap);
+      circuit->compute_structural_keys(keys);
+      signatures.assign(keys.size(), 0);
+      changed.assign(keys.size(), true);
+    }
+
   /*
    * Renumber the gates in temp-fields and
    * compute the number of relevant input gates
@@ -275,12 +424,45 @@ main(const int argc, const char** argv)
           assert(gate->children->child->type != Gate::tNOT);
           gate->temp = -1;
         }
+        else if(opt_varmap_file) {
+	  /* Placeholder, the variable is taken from the map below */
+          gate->temp = 1;
+        }
         else {
           gate->temp = ++gate_num;
         }
 	if(gate->type == Gate::tVAR)
           nof_relevant_input_gates++;
       }
+    if(opt_varmap_file)
+      {
+	for(VarMap::const_iterator it = varmap.begin(); it != varmap.end(); it++)
+	  gate_num = std::max(gate_num, it->second.var);
+	std::set<uint64_t> used_keys;
+	unsigned int nof_new_vars = 0;
+	for(Gate* gate = circuit->first_gate; gate; gate = gate->next)
+	  {
+	    if(gate->temp <= 0)
+	      continue;
+	    uint64_t key = keys[gate->index];
+	    while(!used_keys.insert(key).second)
+	      key = mix64(key, 1);
+	    keys[gate->index] = key;
+	    VarMap::iterator it = varmap.find(key);
+	    if(it == varmap.end())
+	      {
+		VarMapEntry& entry = varmap[key];
+		entry.var = ++gate_num;
+		entry.signature = 0;
+		entry.present = false;
+		nof_new_vars++;
+		gate->temp = entry.var;
+	      }
+	    else
+	      gate->temp = it->second.var;
+	  }
+	verbose_print("The variable map gave %u new variables\n", nof_new_vars);
+      }
     max_var_num = gate_num;
     assert(max_var_num > 0);
     
@@ -385,23 +567,50 @@ c see http://users.ics.aalto.fi/tjunttil/circuits/index.html\n\
 	    gate->cnf_get_clauses(cnf_clauses, opt_cnf_notless);
 	}
 
-	nof_cnf_clauses += cnf_clauses.size();
+	unsigned int nof_gate_clauses = cnf_clauses.size();
+	uint64_t signature = 0;
+	if(opt_varmap_file)
+	  {
+	    for(std::list<std::vector<int> *>::const_iterator it =
+		  cnf_clauses.begin(); it != cnf_clauses.end(); it++)
+	      signature += clause_signature(**it, 0);
+	    for(std::list<std::vector<int> *>::const_iterator it =
+		  xor_clauses.begin(); it != xor_clauses.end(); it++)
+	      signature += clause_signature(**it, 1);
+	  }
 	while(!cnf_clauses.empty()) {delete cnf_clauses.back(); cnf_clauses.pop_back(); }
 	while(!xor_clauses.empty()) {delete xor_clauses.back(); xor_clauses.pop_back(); }
 
 	/*
          * Unit clauses for constrained gates
          */
+	int unit = 0;
         if(gate->determined)
-	  nof_cnf_clauses += 1;
+	  unit = gate->value ? gate->temp : -gate->temp;
 	else
 	  {
 	    /* The following cases should really not happen... */
 	    if(gate->type == Gate::tTRUE)
-	      nof_cnf_clauses += 1;
+	      unit = gate->temp;
 	    else if(gate->type == Gate::tFALSE)
-	      nof_cnf_clauses += 1;
+	      unit = -gate->temp;
+	  }
+	if(unit != 0)
+	  {
+	    nof_gate_clauses++;
+	    signature += clause_signature(std::vector<int>(1, unit), 0);
 	  }
+
+	if(opt_varmap_file)
+	  {
+	    const VarMapEntry& entry = varmap[keys[gate->index]];
+	    signatures[gate->index] = signature;
+	    changed[gate->index] = !(entry.present and
+				     entry.signature == signature);
+	    if(opt_delta and !changed[gate->index])
+	      continue;
+	  }
+	nof_cnf_clauses += nof_gate_clauses;
       }
 
     verbose_print(" done\n");
@@ -409,6 +618,41 @@ c see http://users.ics.aalto.fi/tjunttil/circuits/index.html\n\
 		  max_var_num, nof_cnf_clauses);
     verbose_print("Printing the CNF formula...\n");
 
+    /*
+     * Update the variable map and, for a delta,
+     * list the translations that are no longer in the CNF
+     */
+    if(opt_varmap_file)
+      {
+	std::map<int, uint64_t> current;
+	for(Gate* gate = circuit->first_gate; gate; gate = gate->next)
+	  if(gate->temp > 0)
+	    current[gate->temp] = signatures[gate->index];
+	unsigned int nof_removed = 0;
+	if(opt_delta)
+	  fprintf(outfile, "c This is a delta to the CNF of the previous revision\n");
+	for(VarMap::iterator it = varmap.begin(); it != varmap.end(); it++)
+	  {
+	    VarMapEntry& entry = it->second;
+	    std::map<int, uint64_t>::const_iterator ci = current.find(entry.var);
+	    const bool now_present = (ci != current.end());
+	    if(entry.present and
+	       (!now_present or ci->second != entry.signature))
+	      {
+		if(opt_delta)
+		  fprintf(outfile, "c removed %d\n", entry.var);
+		nof_removed++;
+	      }
+	    entry.present = now_present;
+	    if(now_present)
+	      entry.signature = ci->second;
+	  }
+	write_varmap(opt_varmap_file, varmap);
+	if(opt_delta)
+	  verbose_print("The delta retires %u translations and adds %u clauses\n",
+			nof_removed, nof_cnf_clauses);
+      }
+
     /*
      * Print DIMACS header
      */
@@ -428,6 +672,8 @@ c see http://users.ics.aalto.fi/tjunttil/circuits/index.html\n\
           continue;
         }
 	assert(gate->temp > 0 && gate->temp <= max_var_num);
+	if(opt_delta and !changed[gate->index])
+	  continue;
         /*
          * Get clauses
          */
@@ -16,6 +16,7 @@
 */
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <cstdarg>
 #include "defs.hh"
@@ -36,6 +37,28 @@ static SimplifyOptions simplify_opts;
 static bool opt_branch_only_on_input_gates = false;
 static bool opt_permute_cnf = false;
 static unsigned int opt_permute_cnf_seed = 0;
+static bool opt_structural_hints = false;
+static bool opt_native_xor = false;
+static bool opt_native_cardinality = false;
+static const char *opt_objective = 0;
+static bool opt_maximize = false;
+static bool opt_core_guided = false;
+static const char *opt_checkpoint_file = 0;
+static double opt_checkpoint_interval = 600;
+static const char *opt_resume_file = 0;
+static const char *opt_lemma_cache = 0;
+static unsigned int opt_lemma_cache_size = 10000;
+static const char *opt_proof_file = 0;
+static const char *opt_proof_cnf_file = 0;
+static unsigned int opt_component_threads = 0;
+static bool opt_symmetry = false;
+static bool opt_vmtf = false;
+static bool opt_tiered_reduce = false;
+static bool opt_stable_mode = false;
+static int opt_chrono_backtrack = -1;
+static bool opt_reuse_trail = false;
+static double opt_inprocess_frac = 0;
+static unsigned int opt_simp_threads = 1;
 
 static void
 usage(FILE* const fp, const char* argv0)
@@ -61,6 +84,52 @@ usage(FILE* const fp, const char* argv0)
 "  -nots           perform an unoptimized CNF-translation with NOT-gates\n"
 "  -v              switch verbose mode on\n"
 "  -permute_cnf=s  permute CNF variables with seed s\n"
+"  -struct_hints   initialize branching activities and phases from\n"
+"                  the circuit structure; with -stable, rephasing also\n"
+"                  uses the values of a random circuit simulation\n"
+"  -native_xor     give parity gates to MiniSat as xor-clauses\n"
+"                  (if the circuit is parity-heavy)\n"
+"  -native_card    give threshold gates to MiniSat as cardinality\n"
+"                  constraints\n"
+"  -symmetry       add lex-leader constraints breaking the symmetries of\n"
+"                  the circuit\n"
+"  -vmtf           decide by a variable move-to-front queue instead of\n"
+"                  the VSIDS activity heap\n"
+"  -tiered_reduce  keep the learnt clauses in tiers by their literal block\n"
+"                  distance instead of halving them by activity\n"
+"  -stable         alternate between focused and stable search modes,\n"
+"                  with target phases and rephasing\n"
+"  -chrono=n       backtrack chronologically when a backjump would undo\n"
+"                  more than n decision levels\n"
+"  -reuse_trail    keep the part of the trail that a restart would\n"
+"                  make again\n"
+"  -inprocess=f    vivify learnt clauses and probe failed literals between\n"
+"                  restarts, using at most the fraction f of the search\n"
+"                  propagations\n"
+"  -minimize=l     find a solution minimizing the number of true gates\n"
+"                  in the comma-separated list l of gate names, each\n"
+"                  optionally followed by :weight\n"
+"  -maximize=l     as -minimize=l but maximize\n"
+"  -opt_core       use core-guided instead of linear SAT-UNSAT search\n"
+"                  in optimization\n"
+"  -checkpoint=f   periodically write the solver state to the file f\n"
+"  -checkpoint_interval=s\n"
+"                  write a checkpoint every s CPU seconds (default 600)\n"
+"  -resume=f       continue from the checkpoint file f instead of solving\n"
+"                  a circuit; the solution then includes the named gates\n"
+"                  that were relevant, constant, or inputs\n"
+"  -lemma_cache=f  warm-start from the lemmas over named gates in the file f\n"
+"                  and store the short lemmas learnt back to it\n"
+"  -lemma_cache_size=n\n"
+"                  keep at most n lemmas in the cache (default 10000)\n"
+"  -proof=f        write a binary DRAT proof to the file f\n"
+"  -proof_cnf=f    write the CNF the proof refers to to the file f\n"
+"                  (required by -proof; nothing is written if the circuit\n"
+"                  is found unsatisfiable before the CNF translation)\n"
+"  -components=n   solve the independent parts of the circuit separately\n"
+"                  in n threads\n"
+"  -simp_threads=n run the subsumption checks of the MiniSat preprocessing\n"
+"                  in n threads (default 1)\n"
 "  -print_inputs   print input gate names\n"
 "  <circuit file>  input circuit file (if not specified stdin is used)\n"
 	  , BCPACKAGE_VERSION
@@ -102,6 +171,60 @@ parse_options(const int argc, const char** argv)
 	opt_permute_cnf = true;
 	opt_permute_cnf_seed = seed;
       }
+    else if(strcmp(argv[i], "-struct_hints") == 0)
+      opt_structural_hints = true;
+    else if(strcmp(argv[i], "-native_xor") == 0)
+      opt_native_xor = true;
+    else if(strcmp(argv[i], "-native_card") == 0)
+      opt_native_cardinality = true;
+    else if(strcmp(argv[i], "-symmetry") == 0)
+      opt_symmetry = true;
+    else if(strcmp(argv[i], "-vmtf") == 0)
+      opt_vmtf = true;
+    else if(strcmp(argv[i], "-tiered_reduce") == 0)
+      opt_tiered_reduce = true;
+    else if(strcmp(argv[i], "-stable") == 0)
+      opt_stable_mode = true;
+    else if(sscanf(argv[i], "-chrono=%d", &opt_chrono_backtrack) == 1 and
+	    opt_chrono_backtrack >= 0)
+      ;
+    else if(strcmp(argv[i], "-reuse_trail") == 0)
+      opt_reuse_trail = true;
+    else if(sscanf(argv[i], "-inprocess=%lf", &opt_inprocess_frac) == 1 and
+	    opt_inprocess_frac >= 0)
+      ;
+    else if(strncmp(argv[i], "-minimize=", 10) == 0)
+      {
+	opt_objective = argv[i] + 10;
+	opt_maximize = false;
+      }
+    else if(strncmp(argv[i], "-maximize=", 10) == 0)
+      {
+	opt_objective = argv[i] + 10;
+	opt_maximize = true;
+      }
+    else if(strcmp(argv[i], "-opt_core") == 0)
+      opt_core_guided = true;
+    else if(strncmp(argv[i], "-checkpoint=", 12) == 0)
+      opt_checkpoint_file = argv[i] + 12;
+    else if(sscanf(argv[i], "-checkpoint_interval=%lf",
+		   &opt_checkpoint_interval) == 1)
+      ;
+    else if(strncmp(argv[i], "-resume=", 8) == 0)
+      opt_resume_file = argv[i] + 8;
+    else if(strncmp(argv[i], "-lemma_cache=", 13) == 0)
+      opt_lemma_cache = argv[i] + 13;
+    else if(sscanf(argv[i], "-lemma_cache_size=%u",
+		   &opt_lemma_cache_size) == 1)
+      ;
+    else if(strncmp(argv[i], "-proof=", 7) == 0)
+      opt_proof_file = argv[i] + 7;
+    else if(strncmp(argv[i], "-proof_cnf=", 11) == 0)
+      opt_proof_cnf_file = argv[i] + 11;
+    else if(sscanf(argv[i], "-components=%u", &opt_component_threads) == 1)
+      ;
+    else if(sscanf(argv[i], "-simp_threads=%u", &opt_simp_threads) == 1)
+      ;
     else if(strcmp(argv[i], "-print_inputs") == 0)
       opt_print_input_gates = true;
     else if(argv[i][0] == '-') {
@@ -128,11 +251,53 @@ parse_options(const int argc, const char** argv)
 
 
 
+/*
+ * Build the objective from a comma-separated list of gate names,
+ * each optionally followed by :weight
+ */
+static bool
+build_objective(BC* const circuit, const char* const spec,
+		Objective& objective)
+{
+  char* const list = strdup(spec);
+  bool ok = true;
+  for(char* name = strtok(list, ","); name; name = strtok(0, ","))
+    {
+      unsigned int weight = 1;
+      char* const colon = rindex(name, ':');
+      if(colon)
+	{
+	  *colon = '\0';
+	  if(sscanf(colon + 1, "%u", &weight) != 1 or weight == 0)
+	    {
+	      fprintf(stderr, "invalid weight `%s' in the objective\n",
+		      colon + 1);
+	      ok = false;
+	      break;
+	    }
+	}
+      NameHandle* const handle = circuit->find_gate(name);
+      if(!handle)
+	{
+	  fprintf(stderr, "the objective gate `%s' is not defined\n", name);
+	  ok = false;
+	  break;
+	}
+      objective.gates.push_back(handle);
+      objective.weights.push_back(weight);
+    }
+  free(list);
+  return ok;
+}
+
+
+
 int
 main(const int argc, const char** argv)
 {
   BC* circuit = 0;
   int result = 0;
+  Objective objective;
 
   verbstr = stdout;
 
@@ -140,6 +305,75 @@ main(const int argc, const char** argv)
   
   Timer timer_total;
 
+  if(opt_objective and (opt_checkpoint_file or opt_resume_file))
+    {
+      fprintf(stderr, "checkpoints cannot be used in optimization\n");
+      exit(1);
+    }
+
+  if(opt_proof_file or opt_proof_cnf_file)
+    {
+      if(!opt_proof_file or !opt_proof_cnf_file)
+	{
+	  fprintf(stderr, "-proof and -proof_cnf must be given together\n");
+	  exit(1);
+	}
+      if(opt_native_xor or opt_native_cardinality or opt_objective or
+	 opt_checkpoint_file or opt_resume_file or opt_lemma_cache)
+	{
+	  fprintf(stderr, "proofs cannot be used with native xor-clauses or "
+		  "cardinality constraints, optimization, checkpoints, "
+		  "or the lemma cache\n");
+	  exit(1);
+	}
+    }
+
+  if(opt_objective and opt_symmetry)
+    {
+      fprintf(stderr, "symmetry breaking cannot be used in optimization\n");
+      exit(1);
+    }
+
+  if(opt_component_threads > 0 and
+     (opt_objective or opt_checkpoint_file or opt_resume_file or
+      opt_lemma_cache or opt_proof_file))
+    {
+      fprintf(stderr, "-components cannot be used with optimization, "
+	      "checkpoints, the lemma cache, or proofs\n");
+      exit(1);
+    }
+
+  if(opt_resume_file)
+    {
+      /*
+       * Continue from a checkpoint, the circuit is not needed
+       */
+      std::list<std::pair<std::string, bool> > assignment;
+      verbose_print("Resuming from %s\n", opt_resume_file);
+      result = BC::minisat_resume(opt_resume_file,
+				  opt_checkpoint_file,
+				  opt_checkpoint_interval,
+				  assignment);
+      if(result < 0)
+	{
+	  fprintf(stderr, "cannot read the checkpoint file `%s'\n",
+		  opt_resume_file);
+	  exit(1);
+	}
+      if(result == 0)
+	goto unsat_exit;
+      fprintf(stdout, "Satisfiable\n");
+      if(opt_print_solution)
+	{
+	  for(std::list<std::pair<std::string, bool> >::const_iterator
+		it = assignment.begin(); it != assignment.end(); it++)
+	    fprintf(stdout, "%s%s ", it->second?"":"!", it->first.c_str());
+	  fprintf(stdout, "\n");
+	  fflush(stdout);
+	}
+      goto clean_and_exit;
+    }
+
   verbose_print("Parsing from %s\n", infilename?infilename:"stdin");
   
   circuit = BC::parse_circuit(infile);
@@ -184,6 +418,19 @@ main(const int argc, const char** argv)
    */
   circuit->remove_underscore_names();
 
+  /*
+   * Build the objective, optimization must see all the solutions
+   */
+  if(opt_objective)
+    {
+      if(!build_objective(circuit, opt_objective, objective))
+	exit(1);
+      objective.maximize = opt_maximize;
+      if(opt_core_guided)
+	objective.strategy = Objective::CORE_GUIDED;
+      circuit->preserve_all_solutions = true;
+    }
+
 
   /*
    * Do the actual solving...
@@ -194,7 +441,26 @@ main(const int argc, const char** argv)
 				  opt_notless,
 				  opt_branch_only_on_input_gates,
 				  opt_permute_cnf,
-				  opt_permute_cnf_seed
+				  opt_permute_cnf_seed,
+				  opt_structural_hints,
+				  opt_native_xor,
+				  opt_native_cardinality,
+				  opt_objective ? &objective : 0,
+				  opt_checkpoint_file,
+				  opt_checkpoint_interval,
+				  opt_lemma_cache,
+				  opt_lemma_cache_size,
+				  opt_proof_file,
+				  opt_proof_cnf_file,
+				  opt_component_threads,
+				  opt_symmetry,
+				  opt_vmtf,
+				  opt_tiered_reduce,
+				  opt_stable_mode,
+				  opt_chrono_backtrack,
+				  opt_reuse_trail,
+				  opt_inprocess_frac,
+				  opt_simp_threads
 				  );
   
   if(result == 0)
@@ -203,6 +469,8 @@ main(const int argc, const char** argv)
   DEBUG_ASSERT(result == 1);
       
   fprintf(stdout, "Satisfiable\n");
+  if(opt_objective)
+    fprintf(stdout, "Optimal value: %lu\n", objective.value);
   
   /*
    * Print solution
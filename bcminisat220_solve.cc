@@ -18,7 +18,14 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdarg>
+#include <algorithm>
 #include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
 #include "defs.hh"
 #include "bc.hh"
 #include "timer.hh"
@@ -38,6 +45,25 @@ int BC::minisat_solve(const bool perform_simplifications
 		      , const bool input_cuts_only
 		      , const bool permute_cnf
 		      , const unsigned int permute_cnf_seed
+		      , const bool structural_hints
+		      , const bool native_xor
+		      , const bool native_cardinality
+		      , Objective* const objective
+		      , const char* const checkpoint_file
+		      , const double checkpoint_interval
+		      , const char* const lemma_cache
+		      , const unsigned int lemma_cache_size
+		      , const char* const proof_file
+		      , const char* const proof_cnf_file
+		      , const unsigned int component_threads
+		      , const bool symmetry_breaking
+		      , const bool vmtf
+		      , const bool tiered_reduce
+		      , const bool stable_mode
+		      , const int chrono_backtrack
+		      , const bool reuse_trail
+		      , const double inprocess_frac
+		      , const unsigned int simp_threads
 		      )
 {
   internal_error("no MiniSAT included");
@@ -45,6 +71,17 @@ int BC::minisat_solve(const bool perform_simplifications
 }
 
 
+int BC::minisat_resume(const char* const resume_file
+		       , const char* const checkpoint_file
+		       , const double checkpoint_interval
+		       , std::list<std::pair<std::string, bool> >& assignment
+		       )
+{
+  internal_error("no MiniSAT included");
+  exit(1);
+}
+
+
 #else
 /*
  *
@@ -60,6 +97,675 @@ int BC::minisat_solve(const bool perform_simplifications
 #error "Unknown MiniSAT version defined"
 #endif
 
+#if defined(MINISAT220CORE)
+typedef Minisat::Solver MinisatSolver;
+#elif defined(MINISAT220SIMP)
+typedef Minisat::SimpSolver MinisatSolver;
+#endif
+
+
+/*
+ * A new variable that is never eliminated by the simplifying solver
+ */
+static Minisat::Var
+new_frozen_var(MinisatSolver& solver)
+{
+  const Minisat::Var v = solver.newVar();
+#if defined(MINISAT220SIMP)
+  solver.setFrozen(v, true);
+#endif
+  return v;
+}
+
+
+/*
+ * An incremental totalizer over a list of literals:
+ * the output at_least(k) is true whenever at least k of the literals are.
+ * Only the outputs up to the current limit are encoded;
+ * asking for a larger one extends the encoding without changing
+ * the existing clauses, so the learned clauses remain valid.
+ */
+class Totalizer
+{
+  struct Node {
+    std::vector<Minisat::Lit> outs; /* outs[k-1] is "at least k" */
+    int left, right;                /* -1 in leaves */
+    unsigned int size;              /* number of leaves below */
+  };
+  MinisatSolver& solver;
+  std::vector<Node> nodes;
+  int root;
+  int build(const std::vector<Minisat::Lit>& lits,
+	    const unsigned int begin, const unsigned int end);
+  void extend(const int n, const unsigned int limit);
+public:
+  Totalizer(MinisatSolver& s, const std::vector<Minisat::Lit>& lits,
+	    const unsigned int limit);
+  unsigned int size() const {return nodes[root].size; }
+  /** The literal "at least k of the literals are true", 1 <= k <= size() */
+  Minisat::Lit at_least(const unsigned int k);
+};
+
+Totalizer::Totalizer(MinisatSolver& s,
+		     const std::vector<Minisat::Lit>& lits,
+		     const unsigned int limit) : solver(s)
+{
+  assert(!lits.empty());
+  root = build(lits, 0, lits.size());
+  extend(root, limit);
+}
+
+int
+Totalizer::build(const std::vector<Minisat::Lit>& lits,
+		 const unsigned int begin, const unsigned int end)
+{
+  assert(begin < end);
+  const int n = nodes.size();
+  nodes.push_back(Node());
+  nodes[n].size = end - begin;
+  if(end - begin == 1)
+    {
+      nodes[n].left = nodes[n].right = -1;
+      nodes[n].outs.push_back(lits[begin]);
+      return n;
+    }
+  const unsigned int middle = begin + (end - begin) / 2;
+  const int left = build(lits, begin, middle);
+  const int right = build(lits, middle, end);
+  nodes[n].left = left;
+  nodes[n].right = right;
+  return n;
+}
+
+void
+Totalizer::extend(const int n, const unsigned int limit)
+{
+  if(nodes[n].left == -1)
+    return;
+  const unsigned int old_limit = nodes[n].outs.size();
+  const unsigned int new_limit = std::min(limit, nodes[n].size);
+  if(new_limit <= old_limit)
+    return;
+  extend(nodes[n].left, limit);
+  extend(nodes[n].right, limit);
+  for(unsigned int k = old_limit; k < new_limit; k++)
+    nodes[n].outs.push_back(Minisat::mkLit(new_frozen_var(solver)));
+  /* a_i & b_j -> out_{i+j} for the new outputs only */
+  const std::vector<Minisat::Lit>& a = nodes[nodes[n].left].outs;
+  const std::vector<Minisat::Lit>& b = nodes[nodes[n].right].outs;
+  const std::vector<Minisat::Lit>& outs = nodes[n].outs;
+  Minisat::vec<Minisat::Lit> clause;
+  for(unsigned int i = 0; i <= a.size(); i++)
+    for(unsigned int j = 0; j <= b.size(); j++)
+      {
+	if(i + j <= old_limit or i + j > new_limit)
+	  continue;
+	clause.clear();
+	if(i > 0) clause.push(~a[i-1]);
+	if(j > 0) clause.push(~b[j-1]);
+	clause.push(outs[i+j-1]);
+	solver.addClause(clause);
+      }
+}
+
+Minisat::Lit
+Totalizer::at_least(const unsigned int k)
+{
+  assert(k >= 1 and k <= size());
+  extend(root, k);
+  return nodes[root].outs[k-1];
+}
+
+
+/*
+ * A generalized totalizer (GTE) over weighted literals:
+ * the output at_least(s) is true whenever the weights of the true
+ * literals sum up to at least s. All the sums of at least the limit
+ * share the output of the limit, so the size of the encoding depends on
+ * the number of distinct sums below the limit, not on the weights.
+ */
+class GeneralizedTotalizer
+{
+  typedef std::map<unsigned long, Minisat::Lit> Outputs;
+  MinisatSolver& solver;
+  const unsigned long limit;
+  Outputs outs;  /* of the root, outs[s] is "the sum is at least s" */
+  void build(const std::vector<Minisat::Lit>& lits,
+	     const std::vector<unsigned int>& weights,
+	     const unsigned int begin, const unsigned int end,
+	     Outputs& node_outs);
+public:
+  GeneralizedTotalizer(MinisatSolver& s,
+		       const std::vector<Minisat::Lit>& lits,
+		       const std::vector<unsigned int>& weights,
+		       const unsigned long limit);
+  /** The literal "the sum is at least s", 1 <= s <= limit;
+      lit_Undef if no sum of the weights is that large */
+  Minisat::Lit at_least(const unsigned long s) const;
+};
+
+GeneralizedTotalizer::GeneralizedTotalizer(MinisatSolver& s,
+			const std::vector<Minisat::Lit>& lits,
+			const std::vector<unsigned int>& weights,
+			const unsigned long l) : solver(s), limit(l)
+{
+  assert(!lits.empty() and lits.size() == weights.size());
+  build(lits, weights, 0, lits.size(), outs);
+  /* Make the root outputs monotone: a larger sum implies the smaller */
+  Minisat::Lit larger = Minisat::lit_Undef;
+  for(Outputs::const_reverse_iterator it = outs.rbegin();
+      it != outs.rend(); it++)
+    {
+      if(larger != Minisat::lit_Undef)
+	solver.addClause(~larger, it->second);
+      larger = it->second;
+    }
+}
+
+void
+GeneralizedTotalizer::build(const std::vector<Minisat::Lit>& lits,
+			    const std::vector<unsigned int>& weights,
+			    const unsigned int begin, const unsigned int end,
+			    Outputs& node_outs)
+{
+  assert(begin < end);
+  if(end - begin == 1)
+    {
+      if(weights[begin] > 0)
+	node_outs[std::min((unsigned long)weights[begin], limit)] =
+	  lits[begin];
+      return;
+    }
+  const unsigned int middle = begin + (end - begin) / 2;
+  Outputs left, right;
+  build(lits, weights, begin, middle, left);
+  build(lits, weights, middle, end, right);
+  /* The sum 0 (no literal) is represented by lit_Undef */
+  left[0] = Minisat::lit_Undef;
+  right[0] = Minisat::lit_Undef;
+  for(Outputs::const_iterator a = left.begin(); a != left.end(); a++)
+    for(Outputs::const_iterator b = right.begin(); b != right.end(); b++)
+      {
+	const unsigned long sum = std::min(a->first + b->first, limit);
+	if(sum == 0)
+	  continue;
+	Outputs::iterator out = node_outs.find(sum);
+	if(out == node_outs.end())
+	  out = node_outs.insert(std::make_pair(sum,
+		  Minisat::mkLit(new_frozen_var(solver)))).first;
+	Minisat::vec<Minisat::Lit> clause;
+	if(a->second != Minisat::lit_Undef) clause.push(~a->second);
+	if(b->second != Minisat::lit_Undef) clause.push(~b->second);
+	clause.push(out->second);
+	solver.addClause(clause);
+      }
+}
+
+Minisat::Lit
+GeneralizedTotalizer::at_least(const unsigned long s) const
+{
+  assert(s >= 1 and s <= limit);
+  Outputs::const_iterator it = outs.lower_bound(s);
+  return it == outs.end() ? Minisat::lit_Undef : it->second;
+}
+
+
+/*
+ * The cost of the current model: the weighted number of true cost literals
+ */
+static unsigned long
+model_cost(MinisatSolver& solver,
+	   const std::vector<Minisat::Lit>& lits,
+	   const std::vector<unsigned int>& weights)
+{
+  unsigned long cost = 0;
+  for(unsigned int i = 0; i < lits.size(); i++)
+    if(solver.modelValue(lits[i]) == Minisat::l_True)
+      cost += weights[i];
+  return cost;
+}
+
+
+/*
+ * Linear SAT-UNSAT search: find a solution and keep asking,
+ * by assuming the negation of one generalized totalizer output,
+ * for a strictly cheaper one until there is none.
+ * Returns false if there is no solution at all;
+ * otherwise the best model is left in solver.model.
+ */
+static bool
+optimize_linear(MinisatSolver& solver,
+		const std::vector<Minisat::Lit>& lits,
+		const std::vector<unsigned int>& weights,
+		unsigned long& cost)
+{
+  if(!solver.solve())
+    return false;
+  cost = model_cost(solver, lits, weights);
+  verbose_print("Found a solution of cost %lu\n", cost);
+  if(cost == 0)
+    return true;
+
+  Minisat::vec<Minisat::lbool> best_model;
+  solver.model.copyTo(best_model);
+
+  GeneralizedTotalizer totalizer(solver, lits, weights, cost);
+
+  Minisat::vec<Minisat::Lit> assumptions;
+  while(cost > 0)
+    {
+      /* The weights of the true literals may sum up to at most cost-1 */
+      assumptions.clear();
+      assumptions.push(~totalizer.at_least(cost));
+      if(!solver.solve(assumptions))
+	break;
+      const unsigned long new_cost = model_cost(solver, lits, weights);
+      assert(new_cost < cost);
+      cost = new_cost;
+      verbose_print("Found a solution of cost %lu\n", cost);
+      solver.model.copyTo(best_model);
+    }
+  best_model.moveTo(solver.model);
+  return true;
+}
+
+
+/*
+ * Core-guided search (the OLL algorithm): assume all the cost literals
+ * false and, for each unsatisfiable core, raise the lower bound by the
+ * smallest weight in the core and relax the core with a totalizer whose
+ * next output becomes a new soft literal. The first solution is optimal.
+ * Returns false if there is no solution at all;
+ * otherwise the optimal model is left in solver.model.
+ */
+static bool
+optimize_core_guided(MinisatSolver& solver,
+		     const std::vector<Minisat::Lit>& lits,
+		     const std::vector<unsigned int>& weights,
+		     unsigned long& cost)
+{
+  struct Soft {
+    Minisat::Lit lit;
+    unsigned long weight;
+    int totalizer;      /* -1 for the original cost literals */
+    unsigned int k;     /* lit is totalizers[totalizer]->at_least(k) */
+  };
+  std::vector<Soft> softs;
+  std::vector<Totalizer*> totalizers;
+  unsigned long lower_bound = 0;
+  bool result = false;
+
+  /* A literal occurring several times is one soft with the summed weight */
+  std::map<int, unsigned int> soft_of_lit;
+  for(unsigned int i = 0; i < lits.size(); i++)
+    {
+      std::map<int, unsigned int>::const_iterator it =
+	soft_of_lit.find(Minisat::toInt(lits[i]));
+      if(it != soft_of_lit.end())
+	{
+	  softs[it->second].weight += weights[i];
+	  continue;
+	}
+      soft_of_lit[Minisat::toInt(lits[i])] = softs.size();
+      Soft soft = {lits[i], weights[i], -1, 0};
+      softs.push_back(soft);
+    }
+
+  Minisat::vec<Minisat::Lit> assumptions;
+  while(true)
+    {
+      assumptions.clear();
+      soft_of_lit.clear();
+      for(unsigned int i = 0; i < softs.size(); i++)
+	if(softs[i].weight > 0)
+	  {
+	    assumptions.push(~softs[i].lit);
+	    soft_of_lit[Minisat::toInt(softs[i].lit)] = i;
+	  }
+      if(solver.solve(assumptions))
+	{
+	  cost = model_cost(solver, lits, weights);
+	  assert(cost == lower_bound);
+	  verbose_print("Found a solution of cost %lu\n", cost);
+	  result = true;
+	  break;
+	}
+      if(solver.conflict.size() == 0)
+	break;
+
+      /* The core: the soft literals in the final conflict clause */
+      std::vector<unsigned int> core;
+      unsigned long min_weight = 0;
+      for(int i = 0; i < solver.conflict.size(); i++)
+	{
+	  std::map<int, unsigned int>::const_iterator it =
+	    soft_of_lit.find(Minisat::toInt(solver.conflict[i]));
+	  assert(it != soft_of_lit.end());
+	  core.push_back(it->second);
+	  if(min_weight == 0 or softs[it->second].weight < min_weight)
+	    min_weight = softs[it->second].weight;
+	}
+      lower_bound += min_weight;
+      verbose_print("Found a core of size %lu, the lower bound is %lu\n",
+		    (unsigned long)core.size(), lower_bound);
+
+      std::vector<Minisat::Lit> core_lits;
+      for(unsigned int i = 0; i < core.size(); i++)
+	{
+	  softs[core[i]].weight -= min_weight;
+	  const Soft soft = softs[core[i]];
+	  core_lits.push_back(soft.lit);
+	  /* The next output of a relaxed totalizer becomes soft */
+	  if(soft.totalizer >= 0 and
+	     soft.k < totalizers[soft.totalizer]->size())
+	    {
+	      Soft next = {totalizers[soft.totalizer]->at_least(soft.k + 1),
+			   min_weight, soft.totalizer, soft.k + 1};
+	      softs.push_back(next);
+	    }
+	}
+      if(core_lits.size() == 1)
+	{
+	  /* A unit core: the literal is true in all solutions */
+	  solver.addClause(core_lits[0]);
+	  continue;
+	}
+      /* At least one of the core literals is true,
+	 at least two of them costs min_weight more */
+      totalizers.push_back(new Totalizer(solver, core_lits, 2));
+      Soft relax = {totalizers.back()->at_least(2), min_weight,
+		    (int)totalizers.size() - 1, 2};
+      softs.push_back(relax);
+    }
+
+  for(unsigned int i = 0; i < totalizers.size(); i++)
+    delete totalizers[i];
+  return result;
+}
+
+
+/*
+ * The named gate map stored in a checkpoint: for each name,
+ * a 32-bit code (a MiniSat literal or one of the constants below),
+ * the length of the name and the name.
+ */
+static const int32_t checkpoint_false = -1;
+static const int32_t checkpoint_true = -2;
+
+static void
+checkpoint_append(Minisat::vec<char>& data, const void* const bytes,
+		  const unsigned int nof_bytes)
+{
+  for(unsigned int i = 0; i < nof_bytes; i++)
+    data.push(((const char*)bytes)[i]);
+}
+
+static void
+checkpoint_append_name(Minisat::vec<char>& data, const int32_t code,
+		       const char* const name)
+{
+  const uint32_t length = strlen(name);
+  checkpoint_append(data, &code, sizeof(code));
+  checkpoint_append(data, &length, sizeof(length));
+  checkpoint_append(data, name, length);
+}
+
+
+/*
+ * The CNF a DRAT proof refers to, in DIMACS format with MiniSat variable v
+ * as the variable v+1.
+ * The header is rewritten with the final clause count at the end.
+ */
+static const char* const proof_cnf_header = "p cnf %d %-12u\n";
+
+static void
+proof_cnf_clause(FILE* const fp, const Minisat::vec<Minisat::Lit>& clause)
+{
+  for(int i = 0; i < clause.size(); i++)
+    fprintf(fp, "%s%d ", Minisat::sign(clause[i]) ? "-" : "",
+	    Minisat::var(clause[i]) + 1);
+  fprintf(fp, "0\n");
+}
+
+/*
+ * The lemma cache: short learnt clauses over named gates, kept in a text
+ * file with one "+name" or "-name" line per literal and a "." line ending
+ * each lemma.
+ * Imported lemmas are added only if they are implied by the current CNF,
+ * so a cache written for another circuit is never unsound.
+ */
+static const int lemma_cache_max_size = 8;
+static const int64_t lemma_cache_check_budget = 100;
+
+static bool
+lemma_cache_read_line(FILE* const fp, std::string& line)
+{
+  line.clear();
+  int c;
+  while((c = fgetc(fp)) != EOF and c != '\n')
+    line += (char)c;
+  return !(c == EOF and line.empty());
+}
+
+/*
+ * Is the lemma implied by the clauses in the solver?
+ * First try unit propagation, then a conflict-limited search.
+ */
+static bool
+lemma_is_implied(MinisatSolver& solver,
+		 const std::vector<Minisat::Lit>& lemma)
+{
+  Minisat::vec<Minisat::Lit> assumptions, implied;
+  for(unsigned int i = 0; i < lemma.size(); i++)
+    assumptions.push(~lemma[i]);
+  if(!solver.implies(assumptions, implied))
+    return true;
+  solver.setConfBudget(lemma_cache_check_budget);
+#if defined(MINISAT220SIMP)
+  /* No variable elimination yet, the lemmas are still to be added */
+  const Minisat::lbool r = solver.solveLimited(assumptions, false, false);
+#else
+  const Minisat::lbool r = solver.solveLimited(assumptions);
+#endif
+  solver.budgetOff();
+  return r == Minisat::l_False;
+}
+
+/*
+ * Add the implied lemmas of the cache file to the solver and
+ * collect them in \a imported.
+ * A missing cache file is treated as an empty one.
+ */
+static void
+lemma_cache_import(MinisatSolver& solver, const char* const file,
+		   const std::map<std::string, Minisat::Lit>& name_lits,
+		   std::vector<std::vector<Minisat::Lit> >& imported)
+{
+  FILE* const fp = fopen(file, "r");
+  if(!fp)
+    {
+      verbose_print("Lemma cache %s not found, starting cold\n", file);
+      return;
+    }
+  unsigned int nof_lemmas = 0;
+  unsigned int nof_unknown = 0;
+  unsigned int nof_not_implied = 0;
+  std::vector<Minisat::Lit> lemma;
+  bool known = true;
+  std::string line;
+  const int verbosity = solver.verbosity;
+  solver.verbosity = 0;
+  while(lemma_cache_read_line(fp, line))
+    {
+      if(line.empty())
+	continue;
+      if(line[0] == '+' or line[0] == '-')
+	{
+	  std::map<std::string, Minisat::Lit>::const_iterator it =
+	    name_lits.find(line.substr(1));
+	  if(it == name_lits.end())
+	    known = false;
+	  else
+	    lemma.push_back(line[0] == '+' ? it->second : ~it->second);
+	  continue;
+	}
+      if(line != ".")
+	continue;
+      nof_lemmas++;
+      if(!known)
+	nof_unknown++;
+      else if(!solver.okay() or lemma_is_implied(solver, lemma))
+	{
+	  Minisat::vec<Minisat::Lit> clause;
+	  for(unsigned int i = 0; i < lemma.size(); i++)
+	    clause.push(lemma[i]);
+	  solver.addClause(clause);
+	  imported.push_back(lemma);
+	}
+      else
+	nof_not_implied++;
+      lemma.clear();
+      known = true;
+    }
+  fclose(fp);
+  solver.verbosity = verbosity;
+  verbose_print("Lemma cache: imported %lu of %u lemmas "
+		"(%u over unknown gates, %u not implied)\n",
+		(unsigned long)imported.size(), nof_lemmas,
+		nof_unknown, nof_not_implied);
+}
+
+static bool
+lemma_shorter(const std::vector<Minisat::Lit>& a,
+	      const std::vector<Minisat::Lit>& b)
+{
+  return a.size() < b.size();
+}
+
+/*
+ * Write the imported lemmas and the short learnt clauses over named gates
+ * to the cache file, shortest first and at most \a max_lemmas of them.
+ * \a var_names gives the name of each variable and whether the named gate
+ * is the negation of the variable.
+ */
+static void
+lemma_cache_export(const MinisatSolver& solver, const char* const file,
+		   const unsigned int max_lemmas,
+		   const std::vector<std::pair<const char*, bool> >& var_names,
+		   const std::vector<std::vector<Minisat::Lit> >& imported)
+{
+  std::vector<std::vector<Minisat::Lit> > lemmas(imported);
+  Minisat::vec<Minisat::Lit> learnts;
+  solver.exportLearnts(learnts, lemma_cache_max_size);
+  std::vector<Minisat::Lit> lemma;
+  bool named = true;
+  for(int i = 0; i < learnts.size(); i++)
+    {
+      if(learnts[i] == Minisat::lit_Undef)
+	{
+	  if(named)
+	    lemmas.push_back(lemma);
+	  lemma.clear();
+	  named = true;
+	  continue;
+	}
+      const Minisat::Var v = Minisat::var(learnts[i]);
+      if(v >= (Minisat::Var)var_names.size() or !var_names[v].first)
+	named = false;
+      lemma.push_back(learnts[i]);
+    }
+  std::stable_sort(lemmas.begin(), lemmas.end(), lemma_shorter);
+
+  const std::string tmp_file = std::string(file) + ".tmp";
+  FILE* const fp = fopen(tmp_file.c_str(), "w");
+  if(!fp)
+    {
+      fprintf(stderr, "WARNING: cannot write the lemma cache %s\n", file);
+      return;
+    }
+  std::set<std::vector<int> > written;
+  for(unsigned int i = 0; i < lemmas.size(); i++)
+    {
+      if(written.size() >= max_lemmas)
+	break;
+      std::vector<int> key;
+      for(unsigned int j = 0; j < lemmas[i].size(); j++)
+	key.push_back(Minisat::toInt(lemmas[i][j]));
+      std::sort(key.begin(), key.end());
+      if(!written.insert(key).second)
+	continue;
+      for(unsigned int j = 0; j < lemmas[i].size(); j++)
+	{
+	  const std::pair<const char*, bool>& name =
+	    var_names[Minisat::var(lemmas[i][j])];
+	  const bool positive = Minisat::sign(lemmas[i][j]) == name.second;
+	  fprintf(fp, "%c%s\n", positive ? '+' : '-', name.first);
+	}
+      fprintf(fp, ".\n");
+    }
+  const bool ok = (fclose(fp) == 0);
+  if(!ok or ::rename(tmp_file.c_str(), file) != 0)
+    {
+      fprintf(stderr, "WARNING: cannot write the lemma cache %s\n", file);
+      ::remove(tmp_file.c_str());
+      return;
+    }
+  verbose_print("Lemma cache: wrote %lu lemmas to %s\n",
+		(unsigned long)written.size(), file);
+}
+
+
+/*
+ * Union-find over the relevant gate numbers
+ */
+static int
+component_find(std::vector<int>& parent, int x)
+{
+  while(parent[x] != x)
+    {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+  return x;
+}
+
+
+/*
+ * Solve the independent components with \a nof_threads threads,
+ * the ones with most clauses first.
+ * Returns false as soon as one of them is unsatisfiable,
+ * the others are then interrupted.
+ */
+static bool
+solve_components(std::vector<MinisatSolver*>& solvers,
+		 const unsigned int nof_threads)
+{
+  std::vector<std::pair<int, unsigned int> > order;
+  for(unsigned int i = 0; i < solvers.size(); i++)
+    order.push_back(std::make_pair(-solvers[i]->nClauses(), i));
+  std::sort(order.begin(), order.end());
+
+  std::atomic<unsigned int> next(0);
+  std::atomic<bool> unsat(false);
+  std::vector<std::thread> threads;
+  for(unsigned int t = 0; t < nof_threads and t < solvers.size(); t++)
+    threads.push_back(std::thread([&]() {
+	  const Minisat::vec<Minisat::Lit> no_assumptions;
+	  for(unsigned int i = next++; i < order.size() and !unsat; i = next++)
+	    {
+	      MinisatSolver* const solver = solvers[order[i].second];
+	      if(solver->solveLimited(no_assumptions) != Minisat::l_False)
+		continue;
+	      unsat = true;
+	      for(unsigned int j = 0; j < solvers.size(); j++)
+		solvers[j]->interrupt();
+	    }
+	}));
+  for(unsigned int t = 0; t < threads.size(); t++)
+    threads[t].join();
+  return !unsat;
+}
+
 
 int BC::minisat_solve(const bool perform_simplifications
 		      , const SimplifyOptions& simplify_opts
@@ -68,12 +774,34 @@ int BC::minisat_solve(const bool perform_simplifications
 		      , const bool input_cuts_only
 		      , const bool permute_cnf
 		      , const unsigned int permute_cnf_seed
+		      , const bool structural_hints
+		      , const bool native_xor
+		      , const bool native_cardinality
+		      , Objective* const objective
+		      , const char* const checkpoint_file
+		      , const double checkpoint_interval
+		      , const char* const lemma_cache
+		      , const unsigned int lemma_cache_size
+		      , const char* const proof_file
+		      , const char* const proof_cnf_file
+		      , const unsigned int component_threads
+		      , const bool symmetry_breaking
+		      , const bool vmtf
+		      , const bool tiered_reduce
+		      , const bool stable_mode
+		      , const int chrono_backtrack
+		      , const bool reuse_trail
+		      , const double inprocess_frac
+		      , const unsigned int simp_threads
 		      )
 {
   bool result;
   int max_var_num;
   unsigned int max_clause_length;
   unsigned int nof_clauses = 0;
+  unsigned int nof_xor_clauses = 0;
+  unsigned int nof_cardinality_constraints = 0;
+  bool use_xor = false;
 #if defined(MINISAT220CORE)
   Minisat::Solver *solver = 0;
 #elif defined(MINISAT220SIMP)
@@ -83,6 +811,12 @@ int BC::minisat_solve(const bool perform_simplifications
 #endif
 
   Minisat::Var *map_gatenum_to_minisat_var = 0;
+  std::vector<MinisatSolver*> solvers;
+  std::vector<unsigned int> component;
+  unsigned int nof_components = 1;
+  std::vector<std::pair<const char*, bool> > lemma_var_names;
+  std::vector<std::vector<Minisat::Lit> > lemmas_imported;
+  FILE* proof_cnf = 0;
 
   Timer timer;
 
@@ -98,7 +832,16 @@ int BC::minisat_solve(const bool perform_simplifications
     }
   
 
-  if(!cnf_normalize())
+  if(symmetry_breaking)
+    {
+      unsigned int nof_generators = 0;
+      if(!add_symmetry_breaking(nof_generators))
+	return 0;
+      verbose_print("Added symmetry-breaking constraints for %u generators\n",
+		    nof_generators);
+    }
+
+  if(!cnf_normalize(native_cardinality))
     return 0;
   
   if(perform_simplifications)
@@ -146,6 +889,12 @@ int BC::minisat_solve(const bool perform_simplifications
 	 (gate->determined and !gate->is_justified()))
 	gate->mark_coi(nof_relevant_gates);
     }
+  if(objective)
+    {
+      /* The objective gates are relevant even if unconstrained */
+      for(unsigned int i = 0; i < objective->gates.size(); i++)
+	objective->gates[i]->get_gate()->mark_coi(nof_relevant_gates);
+    }
   verbose_print("The circuit has %d relevant gates\n", nof_relevant_gates);
   if(nof_relevant_gates == 0)
     {
@@ -213,15 +962,73 @@ int BC::minisat_solve(const bool perform_simplifications
 
 
   /*
-   * Init Minisat
+   * Find the connected components of the relevant gates
+   * if they are to be solved separately
+   */
+  component.assign(max_var_num, 0);
+  if(component_threads > 0)
+    {
+      std::vector<int> parent(max_var_num);
+      for(int i = 0; i < max_var_num; i++)
+	parent[i] = i;
+      for(Gate* gate = first_gate; gate; gate = gate->next)
+	{
+	  if(gate->temp <= 0)
+	    continue;
+	  for(const ChildAssoc* ca = gate->children; ca; ca = ca->next_child)
+	    {
+	      /* The NOT gates without a variable are just negated literals */
+	      const Gate* child = ca->child;
+	      while(child->temp <= 0 and child->type == Gate::tNOT)
+		child = child->children->child;
+	      assert(child->temp > 0 and child->temp < max_var_num);
+	      parent[component_find(parent, child->temp)] =
+		component_find(parent, gate->temp);
+	    }
+	}
+      std::vector<int> root_component(max_var_num, -1);
+      nof_components = 0;
+      for(int i = 1; i < max_var_num; i++)
+	{
+	  const int root = component_find(parent, i);
+	  if(root_component[root] == -1)
+	    root_component[root] = nof_components++;
+	  component[i] = root_component[root];
+	}
+      verbose_print("The relevant circuit has %u independent components\n",
+		    nof_components);
+      if(nof_components <= 1)
+	{
+	  nof_components = 1;
+	  component.assign(max_var_num, 0);
+	}
+    }
+
+  /*
+   * Init Minisat, one solver for each component
    */
+  for(unsigned int i = 0; i < nof_components; i++)
+    {
 #if defined(MINISAT220CORE)
-  solver = new Minisat::Solver();
+      solvers.push_back(new Minisat::Solver());
 #elif defined(MINISAT220SIMP)
-  solver = new Minisat::SimpSolver();
+      solvers.push_back(new Minisat::SimpSolver());
 #else
 #error "Unknown MiniSAT version defined"
 #endif
+      solvers.back()->vmtf = vmtf;
+      solvers.back()->tiered_reduce = tiered_reduce;
+      solvers.back()->chrono_backtrack = chrono_backtrack;
+      solvers.back()->reuse_trail = reuse_trail;
+      solvers.back()->inprocess_frac = inprocess_frac;
+      solvers.back()->stable_mode = stable_mode;
+#if defined(MINISAT220SIMP)
+      solvers.back()->subsumption_threads = simp_threads;
+#else
+      (void)simp_threads;
+#endif
+    }
+  solver = solvers[0];
 
   /*
    * Get a minisat variable for each relevant gate
@@ -229,7 +1036,26 @@ int BC::minisat_solve(const bool perform_simplifications
   map_gatenum_to_minisat_var = (Minisat::Var*)calloc(max_var_num, sizeof(Minisat::Var));
   for(int i = 1; i < max_var_num; i++)
     {
-      map_gatenum_to_minisat_var[i] = solver->newVar();
+      map_gatenum_to_minisat_var[i] = solvers[component[i]]->newVar();
+    }
+
+  /*
+   * Start proof logging
+   */
+  if(proof_file)
+    {
+      if(!solver->openProof(proof_file))
+	{
+	  fprintf(stderr, "cannot write the proof file `%s'\n", proof_file);
+	  exit(1);
+	}
+      proof_cnf = fopen(proof_cnf_file, "w");
+      if(!proof_cnf)
+	{
+	  fprintf(stderr, "cannot write the CNF file `%s'\n", proof_cnf_file);
+	  exit(1);
+	}
+      fprintf(proof_cnf, proof_cnf_header, solver->nVars(), 0);
     }
 
 
@@ -237,7 +1063,42 @@ int BC::minisat_solve(const bool perform_simplifications
    * Compute polarity info if needed
    */
   if(polarity_cnf)
-    mir_compute_polarity_information();
+    {
+      mir_compute_polarity_information();
+      /* The values of the objective gates must be exact */
+      if(objective)
+	for(unsigned int i = 0; i < objective->gates.size(); i++)
+	  {
+	    objective->gates[i]->get_gate()->mir_propagate_polarity(true);
+	    objective->gates[i]->get_gate()->mir_propagate_polarity(false);
+	  }
+    }
+
+
+  /*
+   * Give parity gates to MiniSat as xor-clauses if requested and
+   * if at least every tenth relevant non-input gate is a parity gate
+   */
+  if(native_xor)
+    {
+      unsigned int nof_parity_gates = 0;
+      unsigned int nof_noninput_gates = 0;
+      for(Gate *gate = first_gate; gate; gate = gate->next)
+	{
+	  if(gate->temp <= 0 or gate->type == Gate::tVAR)
+	    continue;
+	  nof_noninput_gates++;
+	  if(gate->type == Gate::tEQUIV or
+	     gate->type == Gate::tEVEN or
+	     gate->type == Gate::tODD)
+	    nof_parity_gates++;
+	}
+      use_xor = (nof_parity_gates > 0 and
+		 10 * nof_parity_gates >= nof_noninput_gates);
+      verbose_print("The circuit has %u parity gates out of %u non-input gates, %s xor-clauses\n",
+		    nof_parity_gates, nof_noninput_gates,
+		    use_xor ? "using" : "not using");
+    }
 
 
 
@@ -247,6 +1108,8 @@ int BC::minisat_solve(const bool perform_simplifications
   {
     Minisat::vec<Minisat::Lit> clause;
     std::list<std::vector<int> *> clauses;
+    std::list<std::vector<int> *> xor_clauses;
+    std::list<std::vector<int> *> constraints;
     for(Gate *gate = first_gate; gate; gate = gate->next)
       {
 	assert(gate->temp == -1 || (gate->temp>0 && gate->temp<max_var_num));
@@ -257,7 +1120,21 @@ int BC::minisat_solve(const bool perform_simplifications
         /*
          * Get clauses
          */
-	if(polarity_cnf)
+	if(native_cardinality and gate->type == Gate::tATLEAST)
+	  {
+	    if(polarity_cnf)
+	      gate->cardinality_get_constraints_polarity(constraints, notless);
+	    else
+	      gate->cardinality_get_constraints(constraints, notless);
+	  }
+	else if(use_xor)
+	  {
+	    if(polarity_cnf)
+	      gate->xcnf_get_clauses_polarity(clauses, xor_clauses, notless);
+	    else
+	      gate->xcnf_get_clauses(clauses, xor_clauses, notless);
+	  }
+	else if(polarity_cnf)
 	  gate->cnf_get_clauses_polarity(clauses, notless);
 	else
 	  gate->cnf_get_clauses(clauses, notless);
@@ -284,9 +1161,73 @@ int BC::minisat_solve(const bool perform_simplifications
 		clause.push(minisat_lit);
 	      }
 	    /* Add clause to Minisat */
-	    solver->addClause(clause);
+	    if(proof_cnf)
+	      proof_cnf_clause(proof_cnf, clause);
+#if defined(MINISAT220SIMP)
+	    /* The full translation defines the gate; tell the variable
+	     * elimination, the polarity-based one does not */
+	    if(!polarity_cnf)
+	      solvers[component[abs(cl->front())]]->addDefClause(clause, map_gatenum_to_minisat_var[gate->temp]);
+	    else
+#endif
+	    solvers[component[abs(cl->front())]]->addClause(clause);
 	    nof_clauses++;
 	  }
+
+        /*
+         * Add xor-clauses to Minisat
+         */
+        while(!xor_clauses.empty())
+	  {
+	    std::vector<int> *cl = xor_clauses.back();
+	    xor_clauses.pop_back();
+	    clause.clear();
+	    for(std::vector<int>::iterator li = cl->begin();
+		li != cl->end();
+		li++)
+	      {
+		int lit = *li;
+		assert(lit != 0 && abs(lit) < max_var_num);
+		Minisat::Lit minisat_lit = Minisat::mkLit(map_gatenum_to_minisat_var[abs(lit)]);
+		if(lit < 0)
+		  minisat_lit = ~minisat_lit;
+		clause.push(minisat_lit);
+	      }
+	    solvers[component[abs(cl->front())]]->addXorClause(clause);
+	    delete cl;
+	    nof_xor_clauses++;
+	  }
+
+        /*
+         * Add cardinality constraints [g, k, l1, ..., ln] to Minisat
+         */
+        while(!constraints.empty())
+	  {
+	    std::vector<int> *cl = constraints.back();
+	    constraints.pop_back();
+	    assert(cl->size() >= 3);
+	    clause.clear();
+	    for(std::vector<int>::iterator li = cl->begin() + 2;
+		li != cl->end();
+		li++)
+	      {
+		int lit = *li;
+		assert(lit != 0 && abs(lit) < max_var_num);
+		Minisat::Lit minisat_lit = Minisat::mkLit(map_gatenum_to_minisat_var[abs(lit)]);
+		if(lit < 0)
+		  minisat_lit = ~minisat_lit;
+		clause.push(minisat_lit);
+	      }
+	    const int guard = (*cl)[0];
+	    assert(guard != 0 && abs(guard) < max_var_num);
+	    Minisat::Lit minisat_guard = Minisat::mkLit(map_gatenum_to_minisat_var[abs(guard)]);
+	    if(guard < 0)
+	      minisat_guard = ~minisat_guard;
+	    solvers[component[abs(guard)]]->addAtLeast(clause, (*cl)[1],
+						       minisat_guard);
+	    delete cl;
+	    nof_cardinality_constraints++;
+	  }
 	/*
          * Add unit clauses for constrained gates
          */
@@ -298,7 +1239,9 @@ int BC::minisat_solve(const bool perform_simplifications
 	    if((gate->value == false) ^ negated)
 	      minisat_lit = ~minisat_lit;
 	    clause.push(minisat_lit);
-	    solver->addClause(clause);
+	    if(proof_cnf)
+	      proof_cnf_clause(proof_cnf, clause);
+	    solvers[component[gate->temp]]->addClause(clause);
 	    nof_clauses++;
 	  }
 	else
@@ -308,14 +1251,18 @@ int BC::minisat_solve(const bool perform_simplifications
 	      {
 		clause.clear();
 		clause.push(Minisat::mkLit(map_gatenum_to_minisat_var[gate->temp]));
-		solver->addClause(clause);
+		if(proof_cnf)
+		  proof_cnf_clause(proof_cnf, clause);
+		solvers[component[gate->temp]]->addClause(clause);
 		nof_clauses++;
 	      }
 	    else if(gate->type == Gate::tFALSE)
 	      {
 		clause.clear();
 		clause.push(~Minisat::mkLit(map_gatenum_to_minisat_var[gate->temp]));
-		solver->addClause(clause);
+		if(proof_cnf)
+		  proof_cnf_clause(proof_cnf, clause);
+		solvers[component[gate->temp]]->addClause(clause);
 		nof_clauses++;
 	      }
 	  }
@@ -344,15 +1291,69 @@ int BC::minisat_solve(const bool perform_simplifications
 	  else
 	    {
 	      /* Disable branching on this gate */
-	      solver->setDecisionVar(map_gatenum_to_minisat_var[gate->temp],
+	      solvers[component[gate->temp]]->setDecisionVar(map_gatenum_to_minisat_var[gate->temp],
 				     false);
 	    }
 	}
     }
 
+  /*
+   * Probe the outputs of the circuit and of its shared subcircuits
+   * for failed literals in the inprocessing rounds
+   */
+  for(Gate *gate = first_gate; gate; gate = gate->next)
+    {
+      if(gate->temp <= 0)
+	continue;
+      if(gate->type == Gate::tVAR or
+	 gate->type == Gate::tFALSE or
+	 gate->type == Gate::tTRUE)
+	continue;
+      if(gate->has_parents() and !gate->has_many_parents())
+	continue;
+      solvers[component[gate->temp]]->setProbe(map_gatenum_to_minisat_var[gate->temp],
+					   true);
+    }
+
+  /*
+   * Seed the decision heuristic with structure-derived
+   * initial activities and phases, and give the values of the gates
+   * in the random circuit simulation as an alternative phase for rephasing
+   */
+  if(structural_hints)
+    {
+      std::vector<double> activity;
+      std::vector<bool> phase;
+      std::vector<bool> sim_phase;
+      compute_branching_hints(max_var_num, activity, phase, 0, &sim_phase);
+      for(int i = 1; i < max_var_num; i++)
+	{
+	  solvers[component[i]]->setActivity(map_gatenum_to_minisat_var[i], activity[i]);
+	  solvers[component[i]]->setPhase(map_gatenum_to_minisat_var[i], phase[i]);
+	  solvers[component[i]]->setSimPhase(map_gatenum_to_minisat_var[i], sim_phase[i]);
+	}
+    }
+
+  if(proof_cnf)
+    {
+      rewind(proof_cnf);
+      fprintf(proof_cnf, proof_cnf_header, solver->nVars(), nof_clauses);
+      if(fclose(proof_cnf) != 0)
+	{
+	  fprintf(stderr, "cannot write the CNF file `%s'\n", proof_cnf_file);
+	  exit(1);
+	}
+      proof_cnf = 0;
+    }
+
   verbose_print("CNF translation time: %.2lf\n", timer.get_duration());
   verbose_print("The cnf has %d variables and %d clauses\n",
 		max_var_num-1, nof_clauses);
+  if(use_xor)
+    verbose_print("The cnf has %u xor-clauses\n", nof_xor_clauses);
+  if(native_cardinality)
+    verbose_print("The cnf has %u cardinality constraints\n",
+		  nof_cardinality_constraints);
 
 
   /*
@@ -362,10 +1363,142 @@ int BC::minisat_solve(const bool perform_simplifications
 
   /* Next measure time spent in Minisat */
   timer.reset();
-  solver->verbosity = 2;
-  result = solver->solve();
+  if(nof_components == 1)
+    solver->verbosity = 2;
+
+  /*
+   * Store the named gate map for resuming from a checkpoint:
+   * the relevant gates by their literals, the constant and
+   * irrelevant input gates by their values
+   */
+  if(checkpoint_file)
+    {
+      for(Gate* gate = first_gate; gate; gate = gate->next)
+	for(Handle* handle = gate->handles; handle; handle = handle->get_next())
+	  {
+	    if(handle->get_type() != Handle::ht_NAME)
+	      continue;
+	    int32_t code;
+	    if(gate->temp > 0)
+	      code = Minisat::toInt(Minisat::mkLit(map_gatenum_to_minisat_var[gate->temp]));
+	    else if(notless and gate->type == Gate::tNOT and
+		    gate->children->child->temp > 0)
+	      code = Minisat::toInt(~Minisat::mkLit(map_gatenum_to_minisat_var[gate->children->child->temp]));
+	    else if(gate->determined)
+	      code = gate->value ? checkpoint_true : checkpoint_false;
+	    else if(gate->type == Gate::tVAR)
+	      code = checkpoint_false;
+	    else
+	      continue;
+	    checkpoint_append_name(solver->checkpoint_data, code,
+				   ((NameHandle*)handle)->get_name());
+	  }
+      solver->checkpoint_file = checkpoint_file;
+      solver->checkpoint_interval = checkpoint_interval;
+    }
+
+  /*
+   * Warm-start from the lemma cache: map the named relevant gates
+   * to literals and back
+   */
+  if(lemma_cache)
+    {
+      std::map<std::string, Minisat::Lit> name_lits;
+      lemma_var_names.resize(solver->nVars(),
+			     std::pair<const char*, bool>(0, false));
+      for(Gate* gate = first_gate; gate; gate = gate->next)
+	{
+	  const Gate* var_gate = gate;
+	  bool negated = false;
+	  if(notless and gate->type == Gate::tNOT and gate->temp <= 0)
+	    {
+	      var_gate = gate->children->child;
+	      negated = true;
+	    }
+	  if(var_gate->temp <= 0)
+	    continue;
+	  const Minisat::Var v = map_gatenum_to_minisat_var[var_gate->temp];
+	  for(Handle* handle = gate->handles; handle;
+	      handle = handle->get_next())
+	    {
+	      if(handle->get_type() != Handle::ht_NAME)
+		continue;
+	      const char* const name = ((NameHandle*)handle)->get_name();
+	      if(strchr(name, '\n'))
+		continue;
+	      name_lits[name] = Minisat::mkLit(v, negated);
+	      if(!lemma_var_names[v].first or
+		 (lemma_var_names[v].second and !negated))
+		lemma_var_names[v] = std::make_pair(name, negated);
+	    }
+	}
+      Timer lemma_timer;
+      lemma_cache_import(*solver, lemma_cache, name_lits, lemmas_imported);
+      verbose_print("Lemma cache import time: %.2lf\n",
+		    lemma_timer.get_duration());
+    }
+
+  if(objective)
+    {
+      /*
+       * The cost literals: the objective gates when minimizing,
+       * their negations when maximizing
+       */
+      std::vector<Minisat::Lit> cost_lits;
+      unsigned long total_weight = 0;
+      for(unsigned int i = 0; i < objective->gates.size(); i++)
+	{
+	  const Gate* gate = objective->gates[i]->get_gate();
+	  bool negated = objective->maximize;
+	  if(notless and gate->type == Gate::tNOT)
+	    {
+	      gate = gate->children->child;
+	      negated = !negated;
+	    }
+	  assert(gate->temp > 0 and gate->temp < max_var_num);
+	  Minisat::Lit lit = Minisat::mkLit(map_gatenum_to_minisat_var[gate->temp]);
+	  if(negated)
+	    lit = ~lit;
+#if defined(MINISAT220SIMP)
+	  solver->setFrozen(Minisat::var(lit), true);
+#endif
+	  cost_lits.push_back(lit);
+	  total_weight += objective->weights[i];
+	}
+      unsigned long cost = 0;
+      if(objective->strategy == Objective::CORE_GUIDED)
+	result = optimize_core_guided(*solver, cost_lits, objective->weights,
+				      cost);
+      else
+	result = optimize_linear(*solver, cost_lits, objective->weights, cost);
+      objective->value = objective->maximize ? total_weight - cost : cost;
+      if(result)
+	verbose_print("The optimal value is %lu\n", objective->value);
+    }
+  else if(nof_components > 1)
+    result = solve_components(solvers, component_threads);
+  else
+    result = solver->solve();
   
-  if(verbose) {
+  if(verbose and nof_components > 1) {
+    uint64_t conflicts = 0, decisions = 0, propagations = 0;
+    for(unsigned int i = 0; i < nof_components; i++)
+      {
+	conflicts += solvers[i]->conflicts;
+	decisions += solvers[i]->decisions;
+	propagations += solvers[i]->propagations;
+      }
+    verbose_print("Minisat time: %.2lf\n", timer.get_duration());
+    verbose_print("Minisat statistics over the %u components:\n",
+		  nof_components);
+    verbose_print("conflicts             : %-12lu\n",
+		  (unsigned long)conflicts);
+    verbose_print("decisions             : %-12lu\n",
+		  (unsigned long)decisions);
+    verbose_print("propagations          : %-12lu\n",
+		  (unsigned long)propagations);
+  }
+  else if(verbose) {
     verbose_print("Minisat time: %.2lf\n", timer.get_duration());
     verbose_print("Minisat statistics:\n");
     verbose_print("restarts              : %lu\n",
@@ -377,13 +1510,63 @@ int BC::minisat_solve(const bool perform_simplifications
     verbose_print("propagations          : %-12lu\n",
 		  solver->propagations);
     verbose_print("conflict literals     : %-12lu   (%4.2f %% deleted)\n", solver->tot_literals, (solver->max_literals - solver->tot_literals)*100 / (double)solver->max_literals);
+    if(use_xor)
+      {
+	verbose_print("xor propagations      : %-12lu   (%lu conflicts)\n",
+		      solver->xor_propagations, solver->xor_conflicts);
+	verbose_print("gauss-jordan          : %-12lu   (%lu units, %lu equivalences)\n",
+		      solver->gauss_runs, solver->gauss_units, solver->gauss_equivs);
+      }
+    if(nof_cardinality_constraints > 0)
+      verbose_print("card propagations     : %-12lu   (%lu conflicts, %lu reasons built)\n",
+		    solver->card_propagations, solver->card_conflicts, solver->card_reasons);
+    if(solver->mode_switches > 0)
+      verbose_print("mode switches         : %-12lu   (stable: %lu conflicts, %lu decisions, %lu propagations)\n",
+		    solver->mode_switches, solver->stable_conflicts,
+		    solver->stable_decisions, solver->stable_propagations);
+    if(solver->rephases > 0)
+      verbose_print("rephases              : %-12lu\n", solver->rephases);
+    if(solver->inprocess_rounds > 0)
+      verbose_print("inprocessing          : %-12lu   (%lu vivified, %lu lits removed, %lu probe units)\n",
+		    solver->inprocess_rounds, solver->vivified_clauses,
+		    solver->vivified_lits, solver->probe_units);
+    if(solver->otf_strengthened > 0)
+      verbose_print("otf strengthened      : %-12lu\n", solver->otf_strengthened);
+    if(solver->chrono_backtracks > 0 or solver->missed_implications > 0)
+      verbose_print("chrono backtracks     : %-12lu   (%lu missed implications)\n",
+		    solver->chrono_backtracks, solver->missed_implications);
+    if(solver->reused_trails > 0)
+      verbose_print("reused trails         : %-12lu   (%lu decision levels kept)\n",
+		    solver->reused_trails, solver->reused_levels);
+#if defined(MINISAT220SIMP)
+    if(solver->eliminated_vars > 0)
+      verbose_print("eliminated variables  : %-12d   (%d by gate definitions)\n",
+		    solver->eliminated_vars, solver->gate_eliminated_vars);
+#endif
   }
 
+  if(lemma_cache)
+    lemma_cache_export(*solver, lemma_cache, lemma_cache_size,
+		       lemma_var_names, lemmas_imported);
+
+  if(proof_file)
+    {
+      if(!solver->closeProof())
+	{
+	  fprintf(stderr, "cannot write the proof file `%s'\n", proof_file);
+	  exit(1);
+	}
+      verbose_print("Wrote the proof to %s and its CNF to %s\n",
+		    proof_file, proof_cnf_file);
+    }
+
   
   if(result == false)
     {
       free(map_gatenum_to_minisat_var); map_gatenum_to_minisat_var = 0;
-      delete solver; solver = 0;
+      for(unsigned int i = 0; i < solvers.size(); i++)
+	delete solvers[i];
+      solver = 0;
       return 0;
     }
 
@@ -401,7 +1584,7 @@ int BC::minisat_solve(const bool perform_simplifications
 	    continue;
 	  if(gate->type != Gate::tVAR)
 	    continue;
-	  Minisat::lbool val = solver->model[map_gatenum_to_minisat_var[gate->temp]];
+	  Minisat::lbool val = solvers[component[gate->temp]]->model[map_gatenum_to_minisat_var[gate->temp]];
 	  assert(val == Minisat::lbool(false) or val == Minisat::lbool(true));
 	  bool negated = false;
 	  const bool minisat_value = (val == Minisat::lbool(true)) ^ negated;
@@ -420,7 +1603,9 @@ int BC::minisat_solve(const bool perform_simplifications
 	    }
 	}
       free(map_gatenum_to_minisat_var); map_gatenum_to_minisat_var = 0;
-      delete solver; solver = 0;
+      for(unsigned int i = 0; i < solvers.size(); i++)
+	delete solvers[i];
+      solver = 0;
     }
   
   /*
@@ -463,4 +1648,70 @@ int BC::minisat_solve(const bool perform_simplifications
 }
 
 
+int BC::minisat_resume(const char* const resume_file
+		       , const char* const checkpoint_file
+		       , const double checkpoint_interval
+		       , std::list<std::pair<std::string, bool> >& assignment
+		       )
+{
+  Timer timer;
+  MinisatSolver* const solver = new MinisatSolver();
+
+  if(!solver->readCheckpoint(resume_file))
+    {
+      delete solver;
+      return -1;
+    }
+  verbose_print("Checkpoint reading time: %.2lf\n", timer.get_duration());
+  verbose_print("The cnf has %d variables, %d clauses and %d learnt clauses\n",
+		solver->nVars(), solver->nClauses(), solver->nLearnts());
+
+  /* Decode the named gate map */
+  std::list<std::pair<std::string, int32_t> > names;
+  const char* data = solver->checkpoint_data;
+  const char* const data_end = data + solver->checkpoint_data.size();
+  while(data < data_end)
+    {
+      int32_t code;
+      uint32_t length;
+      memcpy(&code, data, sizeof(code)); data += sizeof(code);
+      memcpy(&length, data, sizeof(length)); data += sizeof(length);
+      names.push_back(std::make_pair(std::string(data, length), code));
+      data += length;
+    }
+
+  if(checkpoint_file)
+    {
+      solver->checkpoint_file = checkpoint_file;
+      solver->checkpoint_interval = checkpoint_interval;
+    }
+
+  verbose_print("Executing minisat...\n");
+  timer.reset();
+  solver->verbosity = 2;
+  const bool result = solver->solve();
+  verbose_print("Minisat time: %.2lf\n", timer.get_duration());
+
+  if(result)
+    {
+      for(std::list<std::pair<std::string, int32_t> >::const_iterator
+	    it = names.begin(); it != names.end(); it++)
+	{
+	  bool value;
+	  if(it->second == checkpoint_true)
+	    value = true;
+	  else if(it->second == checkpoint_false)
+	    value = false;
+	  else
+	    value = (solver->modelValue(Minisat::toLit(it->second)) ==
+		     Minisat::l_True);
+	  assignment.push_back(std::make_pair(it->first, value));
+	}
+    }
+
+  delete solver;
+  return result ? 1 : 0;
+}
+
+
 #endif //BC_HAS_MINISAT
@@ -38,6 +38,25 @@ int BC::minisat_solve(const bool perform_simplifications
 		      , const bool input_cuts_only
 		      , const bool permute_cnf
 		      , const unsigned int permute_cnf_seed
+		      , const bool structural_hints
+		      , const bool native_xor
+		      , const bool native_cardinality
+		      , Objective* const objective
+		      , const char* const checkpoint_file
+		      , const double checkpoint_interval
+		      , const char* const lemma_cache
+		      , const unsigned int lemma_cache_size
+		      , const char* const proof_file
+		      , const char* const proof_cnf_file
+		      , const unsigned int component_threads
+		      , const bool symmetry_breaking
+		      , const bool vmtf
+		      , const bool tiered_reduce
+		      , const bool stable_mode
+		      , const int chrono_backtrack
+		      , const bool reuse_trail
+		      , const double inprocess_frac
+		      , const unsigned int simp_threads
 		      )
 {
   internal_error("no MiniSAT included");
@@ -45,6 +64,17 @@ int BC::minisat_solve(const bool perform_simplifications
 }
 
 
+int BC::minisat_resume(const char* const resume_file
+		       , const char* const checkpoint_file
+		       , const double checkpoint_interval
+		       , std::list<std::pair<std::string, bool> >& assignment
+		       )
+{
+  internal_error("no MiniSAT included");
+  exit(1);
+}
+
+
 #else
 /*
  *
@@ -70,6 +100,25 @@ int BC::minisat_solve(const bool perform_simplifications
 		      , const bool input_cuts_only
 		      , const bool permute_cnf
 		      , const unsigned int permute_cnf_seed
+		      , const bool structural_hints
+		      , const bool native_xor
+		      , const bool native_cardinality
+		      , Objective* const objective
+		      , const char* const checkpoint_file
+		      , const double checkpoint_interval
+		      , const char* const lemma_cache
+		      , const unsigned int lemma_cache_size
+		      , const char* const proof_file
+		      , const char* const proof_cnf_file
+		      , const unsigned int component_threads
+		      , const bool symmetry_breaking
+		      , const bool vmtf
+		      , const bool tiered_reduce
+		      , const bool stable_mode
+		      , const int chrono_backtrack
+		      , const bool reuse_trail
+		      , const double inprocess_frac
+		      , const unsigned int simp_threads
 		      )
 {
   bool result;
@@ -100,6 +149,47 @@ int BC::minisat_solve(const bool perform_simplifications
     }
   
 
+  if(objective)
+    internal_error("optimization is not supported with this MiniSAT version");
+  if(checkpoint_file)
+    internal_error("checkpointing is not supported with this MiniSAT version");
+  if(lemma_cache)
+    internal_error("lemma caching is not supported with this MiniSAT version");
+  if(proof_file)
+    internal_error("proofs are not supported with this MiniSAT version");
+  if(component_threads > 0)
+    internal_error("component decomposition is not supported with this MiniSAT version");
+
+  if(vmtf)
+    internal_error("the move-to-front decision queue is not supported with this MiniSAT version");
+
+  if(tiered_reduce)
+    internal_error("tiered learnt clause reduction is not supported with this MiniSAT version");
+
+  if(stable_mode)
+    internal_error("stable search modes are not supported with this MiniSAT version");
+
+  if(chrono_backtrack >= 0)
+    internal_error("chronological backtracking is not supported with this MiniSAT version");
+
+  if(reuse_trail)
+    internal_error("trail reuse in restarts is not supported with this MiniSAT version");
+
+  if(inprocess_frac > 0)
+    internal_error("inprocessing is not supported with this MiniSAT version");
+
+  if(simp_threads > 1)
+    internal_error("parallel preprocessing is not supported with this MiniSAT version");
+
+  if(symmetry_breaking)
+    {
+      unsigned int nof_generators = 0;
+      if(!add_symmetry_breaking(nof_generators))
+	return 0;
+      verbose_print("Added symmetry-breaking constraints for %u generators\n",
+		    nof_generators);
+    }
+
   if(!cnf_normalize())
     return 0;
   
@@ -507,4 +597,15 @@ int BC::minisat_solve(const bool perform_simplifications
 }
 
 
+int BC::minisat_resume(const char* const resume_file
+		       , const char* const checkpoint_file
+		       , const double checkpoint_interval
+		       , std::list<std::pair<std::string, bool> >& assignment
+		       )
+{
+  internal_error("checkpointing is not supported with this MiniSAT version");
+  exit(1);
+}
+
+
 #endif //BC_HAS_MINISAT
@@ -35,6 +35,7 @@ static bool opt_print_solution = true;
 static bool opt_branch_only_on_input_gates = false;
 static bool opt_permute_cnf = false;
 static unsigned int opt_permute_cnf_seed = 0;
+static unsigned int opt_mem_limit_mb = 1024;
 
 static void
 usage(FILE* const fp, const char* argv0)
@@ -61,6 +62,7 @@ usage(FILE* const fp, const char* argv0)
 "  -nots           perform an unoptimized CNF-translation with NOT-gates\n"
 "  -v              switch verbose mode on\n"
 "  -permute_cnf=s  permute CNF variables with seed s\n"
+"  -mem_limit=m    let zChaff use about m megabytes (default 1024)\n"
 "  <circuit file>  input circuit file (if not specified stdin is used)\n"
 	  , BCPACKAGE_VERSION
           , program_name);
@@ -90,6 +92,8 @@ parse_options(const int argc, const char** argv)
 	opt_permute_cnf = true;
 	opt_permute_cnf_seed = seed;
       }
+    else if(sscanf(argv[i], "-mem_limit=%u", &opt_mem_limit_mb) == 1)
+      ;
     else if(argv[i][0] == '-') {
       fprintf(stderr, "unknown command line argument `%s'\n", argv[i]);
       usage(stderr, argv[0]);
@@ -176,7 +180,8 @@ main(const int argc, const char** argv)
 				 opt_notless,
 				 opt_branch_only_on_input_gates,
 				 opt_permute_cnf,
-				 opt_permute_cnf_seed);
+				 opt_permute_cnf_seed,
+				 opt_mem_limit_mb);
 
   if(result == 0)
     goto unsat_exit;
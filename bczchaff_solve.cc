@@ -33,7 +33,8 @@ int BC::zchaff_solve(const bool perform_simplifications,
 		     const bool notless,
 		     const bool input_cuts_only,
 		     const bool permute_cnf,
-		     const unsigned int permute_cnf_seed)
+		     const unsigned int permute_cnf_seed,
+		     const unsigned int mem_limit_mb)
 {
   internal_error("no ZChaff included");
   exit(1);
@@ -65,6 +66,12 @@ print_zchaff_statistics(SAT_Manager mng, FILE* const fp)
   fprintf(fp, "Deleted Unrelevant literals\t\t%lld\n",
           SAT_NumDeletedLiterals(mng));
   fprintf(fp, "Number of Implication\t\t\t%lld\n", SAT_NumImplications(mng));
+  fprintf(fp, "Lit Pool Chunks Allocated\t\t%d (%.3f s)\n",
+          SAT_NumLitPoolEnlarges(mng), SAT_LitPoolEnlargeTime(mng));
+  fprintf(fp, "Lit Pool Chunk Compactions\t\t%d (%.3f s)\n",
+          SAT_NumLitPoolCompacts(mng), SAT_LitPoolCompactTime(mng));
+  fprintf(fp, "Memory Usage (MB)\t\t\t%.1f\n",
+          SAT_MemUsage(mng) / (1024.0 * 1024.0));
   //other statistics comes here
   //fprintf(fp, "Total Run Time\t\t\t\t%d\n\n", SAT_GetCPUTime(mng));
 }
@@ -77,7 +84,8 @@ BC::zchaff_solve(const bool perform_simplifications,
 		 const bool notless,
 		 const bool input_cuts_only,
 		 const bool permute_cnf,
-		 const unsigned int permute_cnf_seed)
+		 const unsigned int permute_cnf_seed,
+		 const unsigned int mem_limit_mb)
 {
   int result;
   int max_var_num;
@@ -228,6 +236,7 @@ BC::zchaff_solve(const bool perform_simplifications,
    */
   mng = SAT_InitManager();
   SAT_SetNumVariables(mng, max_var_num);
+  SAT_SetMemLimitMB(mng, mem_limit_mb);
   
   if(polarity_cnf)
     mir_compute_polarity_information();
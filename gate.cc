@@ -2518,7 +2518,7 @@ public:
 };
 
 bool
-Gate::cnf_normalize(BC* const bc)
+Gate::cnf_normalize(BC* const bc, const bool native_cardinality)
 {
   if(type == tDELETED)
     return true;
@@ -2763,8 +2763,11 @@ Gate::cnf_normalize(BC* const bc)
       add_in_pstack(bc);
       return true;
 #else
-      /* A heuristic choice between adder and other construction... */
-      if(!((tmax <= 2) or
+      /* A heuristic choice between adder and other construction...
+       * When the solver handles cardinality constraints natively,
+       * the ATLEAST-gates of the sharing construction are kept as such. */
+      if(!native_cardinality and
+	 !((tmax <= 2) or
 	   (tmin + 2 >= nof_children()) or
 	   (tmin <= 2 and tmax + 2 >= nof_children())))
 	{
@@ -2873,6 +2876,9 @@ Gate::cnf_normalize(BC* const bc)
       DEBUG_ASSERT(nof_children() >= 2);
       DEBUG_ASSERT(tmin < nof_children());
 
+      if(native_cardinality)
+	return true;
+
 #define POLYNOMIAL_ATLEAST_REWRITING
 #ifdef POLYNOMIAL_ATLEAST_REWRITING
       /* Based on the equivalence
@@ -4531,6 +4537,71 @@ void Gate::xcnf_get_clauses_polarity(std::list<std::vector<int> *> &cnf_clauses,
 
 
 
+/*
+ * Native cardinality constraints of ATLEAST-gates:
+ *  g -> at least tmin of c1,...,cn are true
+ * !g -> at least n-tmin+1 of !c1,...,!cn are true
+ */
+void Gate::cardinality_get_constraints(std::list<std::vector<int> *> &constraints,
+				       const bool notless)
+{
+  DEBUG_ASSERT(temp >= 1);
+  DEBUG_ASSERT(type == tATLEAST);
+
+  constraints.clear();
+  if(type != tATLEAST)
+    internal_error(text_NI, __FILE__, __LINE__, typeNames[type]);
+
+  const bool pos = mir_pos, neg = mir_neg;
+  mir_pos = true; mir_neg = true;
+  cardinality_get_constraints_polarity(constraints, notless);
+  mir_pos = pos; mir_neg = neg;
+}
+
+void Gate::cardinality_get_constraints_polarity(std::list<std::vector<int> *> &constraints,
+						const bool notless)
+{
+  std::vector<int> *constraint;
+
+  DEBUG_ASSERT(temp >= 1);
+  DEBUG_ASSERT(type == tATLEAST);
+
+  constraints.clear();
+  if(type != tATLEAST)
+    internal_error(text_NI, __FILE__, __LINE__, typeNames[type]);
+
+  const unsigned int n = count_children();
+  DEBUG_ASSERT(tmin >= 1 and tmin <= n);
+  if(mir_pos)
+    {
+      constraint = new std::vector<int>(); constraints.push_back(constraint);
+      constraint->push_back(temp);
+      constraint->push_back(tmin);
+      for(ChildAssoc *ca = children; ca; ca = ca->next_child) {
+	if(notless and ca->child->type == tNOT)
+	  constraint->push_back(-ca->child->children->child->temp);
+	else
+	  constraint->push_back(ca->child->temp);
+      }
+    }
+  if(mir_neg)
+    {
+      constraint = new std::vector<int>(); constraints.push_back(constraint);
+      constraint->push_back(-temp);
+      constraint->push_back(n - tmin + 1);
+      for(ChildAssoc *ca = children; ca; ca = ca->next_child) {
+	if(notless and ca->child->type == tNOT)
+	  constraint->push_back(ca->child->children->child->temp);
+	else
+	  constraint->push_back(-ca->child->temp);
+      }
+    }
+}
+
+
+
+
+
 /*
  *
  * Routines for edimacs format
@@ -5210,6 +5281,77 @@ Gate::evaluate()
 }
 
 
+
+unsigned int
+Gate::simulate(const std::vector<unsigned int>& values) const
+{
+  switch(type) {
+  case tVAR:
+    return values[index];
+  case tFALSE:
+    return 0;
+  case tTRUE:
+    return ~0u;
+  case tREF:
+    return values[children->child->index];
+  case tNOT:
+    return ~values[children->child->index];
+  case tEQUIV: {
+    unsigned int all_true = ~0u, all_false = ~0u;
+    for(const ChildAssoc* ca = children; ca; ca = ca->next_child) {
+      all_true &= values[ca->child->index];
+      all_false &= ~values[ca->child->index];
+    }
+    return all_true | all_false;
+  }
+  case tOR: {
+    unsigned int result = 0;
+    for(const ChildAssoc* ca = children; ca; ca = ca->next_child)
+      result |= values[ca->child->index];
+    return result;
+  }
+  case tAND: {
+    unsigned int result = ~0u;
+    for(const ChildAssoc* ca = children; ca; ca = ca->next_child)
+      result &= values[ca->child->index];
+    return result;
+  }
+  case tODD:
+  case tEVEN: {
+    unsigned int result = (type == tODD)?0:~0u;
+    for(const ChildAssoc* ca = children; ca; ca = ca->next_child)
+      result ^= values[ca->child->index];
+    return result;
+  }
+  case tITE: {
+    const unsigned int if_values = values[children->child->index];
+    const unsigned int then_values = values[children->next_child->child->index];
+    const unsigned int else_values = values[children->next_child->next_child->child->index];
+    return (if_values & then_values) | (~if_values & else_values);
+  }
+  case tTHRESHOLD:
+  case tATLEAST: {
+    /* No bit tricks here, count the true children in each simulation */
+    unsigned int result = 0;
+    for(unsigned int bit = 0; bit < 32; bit++) {
+      unsigned int nof_true_children = 0;
+      for(const ChildAssoc* ca = children; ca; ca = ca->next_child)
+	if((values[ca->child->index] >> bit) & 1)
+	  nof_true_children++;
+      if(tmin <= nof_true_children and
+	 (type == tATLEAST or nof_true_children <= tmax))
+	result |= (1u << bit);
+    }
+    return result;
+  }
+  default:
+    internal_error(text_NI, __FILE__, __LINE__, typeNames[type]);
+  }
+  assert(should_not_happen);
+  return 0;
+}
+
+
 /*
  * Returns false if the current truth assignment is not consistent
  */
@@ -5321,6 +5463,16 @@ bool Gate::check_consistency()
     if(nof_true >= tmin and nof_children - nof_false <= tmax)
       return false;
     return true;
+  case tATLEAST:
+    if(value == true) {
+      if(nof_children - nof_false < tmin)
+	return false;
+      return true;
+    }
+    /* value == false */
+    if(nof_true >= tmin)
+      return false;
+    return true;
   default:
     internal_error(text_NI, __FILE__, __LINE__, typeNames[type]);
   }
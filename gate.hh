@@ -149,7 +149,7 @@ public:
   ~Gate();
 
   bool share(BC * const bc, GateHash * const ht, Gate ** const cache);
-  bool cnf_normalize(BC* const bc);
+  bool cnf_normalize(BC* const bc, const bool native_cardinality = false);
 
 
   void cnf_get_clauses(std::list<std::vector<int> *> &clauses,
@@ -166,6 +166,19 @@ public:
 				 std::list<std::vector<int> *> &xor_clauses,
 				 const bool notless);
 
+  /**
+   * Get the cardinality constraints of an ATLEAST-gate left in place by
+   * BC::cnf_normalize(true).
+   * Each constraint is a vector [g, k, l1, ..., ln] meaning that
+   * if the literal g is true, then at least k of the literals l1,...,ln
+   * are true.
+   */
+  void cardinality_get_constraints(std::list<std::vector<int> *> &constraints,
+				   const bool notless);
+  /** Get the cardinality constraints with polarity. */
+  void cardinality_get_constraints_polarity(std::list<std::vector<int> *> &constraints,
+					    const bool notless);
+
   bool edimacs_normalize(BC* const bc);
   void edimacs_print(FILE* const fp, const bool notless);
   void edimacs_print_children(FILE* const fp, const bool notless);
@@ -241,6 +254,14 @@ public:
    */
   bool evaluate();
 
+  /**
+   * Bit-parallel simulation: given the values of the children of the gate
+   * in 32 simulations (stored in \a values by the gate index),
+   * return the values of the gate in the same simulations.
+   * For input gates, the value already in \a values is returned.
+   */
+  unsigned int simulate(const std::vector<unsigned int>& values) const;
+
   /**
    * Returns true iff the value of the gate is determined and
    * justified by the values of children.
@@ -0,0 +1,125 @@
+/***********************************************************************************[DratWriter.cc]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "minisat/mtl/XAlloc.h"
+#include "minisat/core/DratWriter.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Constructor/Destructor:
+
+
+DratWriter::DratWriter() :
+    file   (NULL)
+  , current(0)
+  , used   (0)
+  , pending(0)
+  , closing(false)
+  , failed (false)
+{
+    buffers[0] = buffers[1] = NULL;
+}
+
+
+DratWriter::~DratWriter()
+{
+    close();
+}
+
+
+//=================================================================================================
+// Opening and closing:
+
+
+bool DratWriter::open(const char* file_name)
+{
+    close();
+    file = fopen(file_name, "wb");
+    if (file == NULL)
+        return false;
+
+    buffers[0] = (unsigned char*)xrealloc(NULL, buffer_size);
+    buffers[1] = (unsigned char*)xrealloc(NULL, buffer_size);
+    current = used = pending = 0;
+    closing = failed = false;
+    writer  = std::thread(&DratWriter::writerLoop, this);
+    return true;
+}
+
+
+bool DratWriter::close()
+{
+    if (file == NULL)
+        return true;
+
+    handOver();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        closing = true;
+    }
+    cond.notify_all();
+    writer.join();
+
+    if (fclose(file) != 0) failed = true;
+    file = NULL;
+    free(buffers[0]);
+    free(buffers[1]);
+    buffers[0] = buffers[1] = NULL;
+    return !failed;
+}
+
+
+//=================================================================================================
+// Background writing:
+
+
+void DratWriter::handOver()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (pending > 0)
+        cond.wait(lock);
+    pending = used;
+    current = 1 - current;
+    used    = 0;
+    lock.unlock();
+    cond.notify_all();
+}
+
+
+void DratWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;){
+        while (pending == 0 && !closing)
+            cond.wait(lock);
+        if (pending == 0)
+            return;
+
+        // The full buffer is the one not being filled; write it without holding the lock:
+        const unsigned char* buf = buffers[1 - current];
+        int                  len = pending;
+        lock.unlock();
+        bool ok = fwrite(buf, 1, len, file) == (size_t)len;
+        lock.lock();
+
+        if (!ok) failed = true;
+        pending = 0;
+        cond.notify_all();
+    }
+}
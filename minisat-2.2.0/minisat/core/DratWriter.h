@@ -0,0 +1,88 @@
+/************************************************************************************[DratWriter.h]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_DratWriter_h
+#define Minisat_DratWriter_h
+
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "minisat/core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// DratWriter -- streams a proof in the binary DRAT format:
+//
+// Each added clause is written as the byte 'a' and each deleted clause as the byte 'd', followed
+// by the literals and a zero byte. A literal 'l' is written as the unsigned number
+// '2*(var(l)+1) + sign(l)' in 7-bit groups, least significant first, with the high bit set in all
+// but the last group. The variable 'v' of the solver is thus the variable 'v+1' of the DIMACS
+// file the proof refers to.
+//
+// The proof is collected into one buffer while a background thread writes the other one.
+
+
+class DratWriter {
+    enum { buffer_size = 1 << 20 };
+
+    FILE*                   file;
+    unsigned char*          buffers[2];
+    int                     current;       // The buffer being filled.
+    int                     used;          // Number of bytes in the current buffer.
+
+    std::thread             writer;
+    std::mutex              mutex;
+    std::condition_variable cond;
+    int                     pending;       // Number of bytes to write from the other buffer (0 if it is free).
+    bool                    closing;
+    bool                    failed;        // TRUE if a write has failed.
+
+    void writerLoop();
+    void handOver();                       // Pass the current buffer to the writer thread and switch to the other one.
+
+    void put(unsigned char b) { if (used == buffer_size) handOver(); buffers[current][used++] = b; }
+    void putLit(Lit p) {
+        unsigned int u = 2 * (var(p) + 1) + sign(p);
+        while (u > 127){ put((unsigned char)(u | 128)); u >>= 7; }
+        put((unsigned char)u); }
+    template<class Lits> void lits(const Lits& c, Lit except) {
+        for (int i = 0; i < c.size(); i++)
+            if (c[i] != except)
+                putLit(c[i]);
+        put(0); }
+
+public:
+    DratWriter();
+    ~DratWriter();
+
+    bool open (const char* file_name);     // Start a new proof file, FALSE if it cannot be created.
+    bool close();                          // Flush and close the proof, FALSE if some write failed.
+
+    // Log the addition/deletion of a clause, leaving out the literal 'except' (if any):
+    template<class Lits> void add   (const Lits& c, Lit except = lit_Undef) { put('a'); lits(c, except); }
+    template<class Lits> void remove(const Lits& c, Lit except = lit_Undef) { put('d'); lits(c, except); }
+    void                      addEmpty() { put('a'); put(0); }
+};
+
+//=================================================================================================
+}
+
+#endif
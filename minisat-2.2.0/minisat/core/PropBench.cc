@@ -0,0 +1,133 @@
+/************************************************************************************[PropBench.cc]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <zlib.h>
+
+#include "minisat/utils/System.h"
+#include "minisat/utils/ParseUtils.h"
+#include "minisat/utils/Options.h"
+#include "minisat/core/Dimacs.h"
+#include "minisat/core/Solver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// A micro-benchmark of 'Solver::propagate()'. It is built as 'minisat_propbench_a' with the default
+// watcher layout and as 'minisat_propbench_b' with 'MINISAT_INLINE_WATCHERS' (see the option
+// 'MINISAT_PROPBENCH' in CMakeLists.txt). Both do exactly the same work on a CNF, which the
+// propagation counts printed confirm, so the difference in time is that of the layouts. The
+// script 'propbench.sh' runs both on a set of CNFs.
+
+
+class PropBench : public Solver {
+  public:
+    int  randomRounds(int rounds, double seed); // Returns the number of conflicts met.
+    static int watcherSize() { return sizeof(Watcher); }
+};
+
+
+// Assigns the variables in a random order and with random signs, propagating each decision, until
+// a conflict or a full assignment; then backtracks to the top level. This is repeated 'rounds'
+// times and exercises only the original clauses:
+int PropBench::randomRounds(int rounds, double seed)
+{
+    int      conflicts = 0;
+    vec<Var> vs;
+    for (Var v = 0; v < nVars(); v++)
+        if (value(v) == l_Undef)
+            vs.push(v);
+
+    for (int r = 0; r < rounds; r++){
+        for (int i = vs.size() - 1; i > 0; i--){
+            int k = irand(seed, i + 1);
+            Var t = vs[i]; vs[i] = vs[k]; vs[k] = t; }
+
+        for (int i = 0; i < vs.size(); i++){
+            if (value(vs[i]) != l_Undef) continue;
+            newDecisionLevel();
+            uncheckedEnqueue(mkLit(vs[i], drand(seed) < 0.5));
+            if (propagate() != CRef_Undef){
+                conflicts++;
+                break; }
+        }
+        cancelUntil(0);
+    }
+
+    return conflicts;
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    try {
+        setUsageHelp("USAGE: %s [options] <input-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+        setX86FPUPrecision();
+
+        IntOption    rounds ("BENCH", "rounds",    "Number of rounds of random decisions.", 1000, IntRange(0, INT32_MAX));
+        IntOption    confl  ("BENCH", "conflicts", "Conflicts of search after the rounds (learnt clauses included).", 20000, IntRange(0, INT32_MAX));
+        IntOption    seed   ("BENCH", "seed",      "Seed of the random decisions.", 91648253, IntRange(1, INT32_MAX));
+
+        parseOptions(argc, argv, true);
+
+        PropBench S;
+        S.verbosity = 0;
+
+        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
+        if (in == NULL)
+            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
+        parse_DIMACS(in, S);
+        gzclose(in);
+
+#ifdef MINISAT_INLINE_WATCHERS
+        printf("layout:  inline (%d bytes per watcher)\n", PropBench::watcherSize());
+#else
+        printf("layout:  default (%d bytes per watcher)\n", PropBench::watcherSize());
+#endif
+        if (!S.simplify()){
+            printf("UNSATISFIABLE by unit propagation\n");
+            exit(0); }
+
+        uint64_t props0 = S.propagations;
+        double   time0  = cpuTime();
+        int      rconfl = S.randomRounds(rounds, seed);
+        uint64_t props1 = S.propagations;
+        double   time1  = cpuTime();
+
+        vec<Lit> dummy;
+        if (confl > 0){
+            S.setConfBudget(confl);
+            S.solveLimited(dummy); }
+        uint64_t props2 = S.propagations;
+        double   time2  = cpuTime();
+
+        printf("rounds:  %12" PRIu64 " propagations %10d conflicts %10.3f s %10.3f Mprops/s\n",
+               props1 - props0, rconfl, time1 - time0, (props1 - props0) / ((time1 - time0) * 1e6 + 1e-9));
+        printf("search:  %12" PRIu64 " propagations %10" PRIu64 " conflicts %10.3f s %10.3f Mprops/s\n",
+               props2 - props1, S.conflicts, time2 - time1, (props2 - props1) / ((time2 - time1) * 1e6 + 1e-9));
+
+        exit(0);
+    } catch (OutOfMemoryException&){
+        printf("INDETERMINATE (out of memory)\n");
+        exit(0);
+    }
+}
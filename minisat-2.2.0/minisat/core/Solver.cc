@@ -19,6 +19,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <math.h>
+#include <string.h>
 
 #include "minisat/mtl/Alg.h"
 #include "minisat/mtl/Sort.h"
@@ -45,6 +46,22 @@ static IntOption     opt_restart_first     (_cat, "rfirst",      "The base resta
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_min_learnts_lim   (_cat, "min-learnts", "Minimum learnt clause limit",  0, IntRange(0, INT32_MAX));
+static BoolOption    opt_tiered_reduce     (_cat, "tiered-reduce","Reduce the learnt clauses in LBD tiers on a conflict schedule", false);
+static IntOption     opt_core_lbd          (_cat, "core-lbd",    "Keep learnt clauses with at most this LBD forever (tiered-reduce)", 2, IntRange(0, INT32_MAX));
+static IntOption     opt_tier2_lbd         (_cat, "tier2-lbd",   "Keep learnt clauses with at most this LBD while they are used (tiered-reduce)", 6, IntRange(0, INT32_MAX));
+static IntOption     opt_first_reduce      (_cat, "first-reduce","The number of conflicts before the first learnt clause reduction (tiered-reduce)", 2000, IntRange(1, INT32_MAX));
+static IntOption     opt_inc_reduce        (_cat, "inc-reduce",  "The increase of the learnt clause reduction interval (tiered-reduce)", 300, IntRange(0, INT32_MAX));
+static BoolOption    opt_stable_mode       (_cat, "stable",      "Alternate between a focused and a stable search mode, with rephasing", false);
+static IntOption     opt_mode_first        (_cat, "mode-first",  "The number of conflicts in the first focused mode", 1000, IntRange(1, INT32_MAX));
+static IntOption     opt_stable_rfirst     (_cat, "stable-rfirst","The base restart interval in the stable mode", 1024, IntRange(1, INT32_MAX));
+static DoubleOption  opt_stable_var_decay  (_cat, "stable-var-decay","The variable activity decay factor in the stable mode", 0.975, DoubleRange(0, false, 1, false));
+static IntOption     opt_rephase_first     (_cat, "rephase-first","The number of conflicts before the first rephasing", 1000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_inprocess_frac    (_cat, "inprocess",   "The propagation budget of inprocessing relative to search (0 disables)", 0, DoubleRange(0, true, HUGE_VAL, false));
+static IntOption     opt_chrono            (_cat, "chrono",      "Backtrack chronologically when a backjump would undo more levels than this (-1 = never)", -1, IntRange(-1, INT32_MAX));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Keep the part of the trail that a restart would make again", false);
+static BoolOption    opt_vmtf              (_cat, "vmtf",        "Decide by a variable move-to-front queue instead of the activity heap", false);
+static BoolOption    opt_gauss             (_cat, "gauss",       "Use Gauss-Jordan elimination on xor-clauses", true);
+static IntOption     opt_gauss_max_cells   (_cat, "gauss-max",   "Maximum number of cells in the Gauss-Jordan matrix", 4000000, IntRange(0, INT32_MAX));
 
 
 //=================================================================================================
@@ -67,12 +84,27 @@ Solver::Solver() :
   , rnd_init_act     (opt_rnd_init_act)
   , garbage_frac     (opt_garbage_frac)
   , min_learnts_lim  (opt_min_learnts_lim)
+  , gauss            (opt_gauss)
+  , gauss_max_cells  (opt_gauss_max_cells)
+  , checkpoint_file  (NULL)
+  , checkpoint_interval (600)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
-
-    // Parameters (the rest):
-    //
   , learntsize_factor((double)1/(double)3), learntsize_inc(1.1)
+  , tiered_reduce    (opt_tiered_reduce)
+  , core_lbd         (opt_core_lbd)
+  , tier2_lbd        (opt_tier2_lbd)
+  , first_reduce     (opt_first_reduce)
+  , inc_reduce       (opt_inc_reduce)
+  , stable_mode      (opt_stable_mode)
+  , mode_first       (opt_mode_first)
+  , stable_restart_first (opt_stable_rfirst)
+  , stable_var_decay (opt_stable_var_decay)
+  , rephase_first    (opt_rephase_first)
+  , inprocess_frac   (opt_inprocess_frac)
+  , chrono_backtrack (opt_chrono)
+  , reuse_trail      (opt_reuse_trail)
+  , vmtf             (opt_vmtf)
 
     // Parameters (experimental):
     //
@@ -83,9 +115,19 @@ Solver::Solver() :
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), num_clauses(0), num_learnts(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , num_xors(0), xor_propagations(0), xor_conflicts(0), gauss_runs(0), gauss_units(0), gauss_equivs(0)
+  , num_cards(0), card_propagations(0), card_conflicts(0), card_reasons(0)
+  , stable_conflicts(0), stable_decisions(0), stable_propagations(0), mode_switches(0), rephases(0)
+  , inprocess_rounds(0), vivified_clauses(0), vivified_lits(0), otf_strengthened(0), probe_units(0)
+  , chrono_backtracks(0), missed_implications(0), reused_trails(0), reused_levels(0)
 
   , watches            (WatcherDeleted(ca))
-  , order_heap         (VarOrderLt(activity))
+  , watches_bin        (WatcherDeleted(ca))
+  , vmtf_first         (var_Undef)
+  , vmtf_last          (var_Undef)
+  , vmtf_search        (var_Undef)
+  , vmtf_time          (0)
+  , vmtf_sorted        (false)
   , ok                 (true)
   , cla_inc            (1)
   , var_inc            (1)
@@ -95,17 +137,37 @@ Solver::Solver() :
   , progress_estimate  (0)
   , remove_satisfied   (true)
   , next_var           (0)
+  , lbd_stamp          (0)
+  , target_assigned    (0)
+  , best_assigned      (0)
+  , stable             (false)
+  , has_sim_pol        (false)
+  , next_mode_switch   (0)
+  , mode_interval      (0)
+  , next_rephase       (0)
+  , focused_restarts   (0)
+  , stable_restarts    (0)
+  , probe_next         (0)
+  , vivify_next        (0)
+  , inprocess_props    (0)
+  , inprocess_pending  (false)
+  , next_reduce        (0)
+  , reduce_interval    (0)
 
     // Resource constraints:
     //
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
+
+  , checkpoint_next    (0)
+  , proof              (NULL)
 {}
 
 
 Solver::~Solver()
 {
+    delete proof;
 }
 
 
@@ -122,18 +184,37 @@ Var Solver::newVar(lbool upol, bool dvar)
     if (free_vars.size() > 0){
         v = free_vars.last();
         free_vars.pop();
+        vmtfDequeue(v);
     }else
         v = next_var++;
 
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
     assigns  .insert(v, l_Undef);
     vardata  .insert(v, mkVarData(CRef_Undef, 0));
     activity .insert(v, rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen     .insert(v, 0);
+    tmp_reason.insert(v, 0);
+    if ((int)xor_watches.size() <= v) xor_watches.resize(v+1);
+    card_reason.insert(v, -1);
+    trail_pos.insert(v, -1);
+    probe    .insert(v, 0);
+    if ((int)card_occs.size() < 2*v+2){
+        card_occs  .resize(2*v+2);
+        card_guards.resize(2*v+2); }
     polarity .insert(v, true);
+    init_pol .insert(v, true);
+    sim_pol  .insert(v, l_Undef);
+    target_pol.insert(v, true);
+    best_pol .insert(v, true);
     user_pol .insert(v, upol);
     decision .reserve(v);
+    vmtf_prev.insert(v, var_Undef);
+    vmtf_next.insert(v, var_Undef);
+    vmtf_stamp.insert(v, 0);
+    vmtfEnqueue(v);
     trail    .capacity(v+1);
     setDecisionVar(v, dvar);
     return v;
@@ -166,11 +247,18 @@ bool Solver::addClause_(vec<Lit>& ps)
             ps[j++] = p = ps[i];
     ps.shrink(i - j);
 
+    // (the clause as given is assumed to be in the proof already, log the shortened one)
+    if (proof != NULL && i != j)
+        proof->add(ps);
+
     if (ps.size() == 0)
         return ok = false;
     else if (ps.size() == 1){
         uncheckedEnqueue(ps[0]);
-        return ok = (propagate() == CRef_Undef);
+        if (propagate() == CRef_Undef)
+            return true;
+        if (proof != NULL) proof->addEmpty();
+        return ok = false;
     }else{
         CRef cr = ca.alloc(ps, false);
         clauses.push(cr);
@@ -181,11 +269,115 @@ bool Solver::addClause_(vec<Lit>& ps)
 }
 
 
+bool Solver::addXorClause(const vec<Lit>& ps)
+{
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+
+    // Move the signs to the right-hand side, cancel duplicate variables and remove assigned ones:
+    vec<Var> vs;
+    bool     rhs = true;
+    for (int i = 0; i < ps.size(); i++){
+        vs.push(var(ps[i]));
+        rhs ^= sign(ps[i]); }
+    sort(vs);
+    int i, j;
+    for (i = j = 0; i < vs.size(); i++)
+        if (value(vs[i]) != l_Undef)
+            rhs ^= (value(vs[i]) == l_True);
+        else if (i+1 < vs.size() && vs[i+1] == vs[i])
+            i++;
+        else
+            vs[j++] = vs[i];
+    vs.shrink(i - j);
+
+    if (vs.size() == 0)
+        return rhs ? (ok = false) : true;
+    else if (vs.size() == 1){
+        uncheckedEnqueue(mkLit(vs[0], !rhs));
+        return ok = (propagate() == CRef_Undef);
+    }else
+        addXor_(vs, rhs);
+
+    return true;
+}
+
+
+bool Solver::addAtLeast(const vec<Lit>& ps, int k, Lit guard)
+{
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+
+    if (guard != lit_Undef){
+        if (value(guard) == l_False)
+            return true;
+        else if (value(guard) == l_True)
+            guard = lit_Undef; }
+
+    // Remove assigned literals:
+    vec<Lit> lits;
+    for (int i = 0; i < ps.size(); i++)
+        if (value(ps[i]) == l_True)
+            k--;
+        else if (value(ps[i]) == l_Undef)
+            lits.push(ps[i]);
+
+    if (k <= 0)
+        return true;
+    else if (k > lits.size()){
+        if (guard == lit_Undef)
+            return ok = false;
+        uncheckedEnqueue(~guard);
+        return ok = (propagate() == CRef_Undef);
+    }else if (k == lits.size() && guard == lit_Undef){
+        for (int i = 0; i < lits.size(); i++)
+            if (value(lits[i]) == l_False)
+                return ok = false;
+            else if (value(lits[i]) == l_Undef)
+                uncheckedEnqueue(lits[i]);
+        return ok = (propagate() == CRef_Undef);
+    }
+
+    CardConstraint c;
+    c.first     = card_lits.size();
+    c.size      = lits.size();
+    c.guard     = guard;
+    c.bound     = k;
+    c.nof_false = 0;
+    for (int j = 0; j < lits.size(); j++){
+        card_lits.push(lits[j]);
+        card_occs[toInt(lits[j])].push_back(cards.size()); }
+    if (guard != lit_Undef)
+        card_guards[toInt(guard)].push_back(cards.size());
+    cards.push(c);
+    num_cards++;
+
+    return true;
+}
+
+
+void Solver::addXor_(vec<Var>& vs, bool rhs)
+{
+    assert(vs.size() > 1 && value(vs[0]) == l_Undef && value(vs[1]) == l_Undef);
+    XorClause x;
+    x.first = xor_vars.size();
+    x.size  = vs.size();
+    x.rhs   = rhs;
+    for (int k = 0; k < vs.size(); k++)
+        xor_vars.push(vs[k]);
+    xor_watches[vs[0]].push_back(xors.size());
+    xor_watches[vs[1]].push_back(xors.size());
+    xors.push(x);
+    num_xors++;
+}
+
+
 void Solver::attachClause(CRef cr){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>& ws = c.size() == 2 ? watches_bin : watches;
+    ws[~c[0]].push(Watcher(cr, c[1], c.size()));
+    ws[~c[1]].push(Watcher(cr, c[0], c.size()));
     if (c.learnt()) num_learnts++, learnts_literals += c.size();
     else            num_clauses++, clauses_literals += c.size();
 }
@@ -194,14 +386,15 @@ void Solver::attachClause(CRef cr){
 void Solver::detachClause(CRef cr, bool strict){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>& ws = c.size() == 2 ? watches_bin : watches;
     
     // Strict or lazy detaching:
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1], c.size()));
+        remove(ws[~c[1]], Watcher(cr, c[0], c.size()));
     }else{
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if (c.learnt()) num_learnts--, learnts_literals -= c.size();
@@ -211,9 +404,10 @@ void Solver::detachClause(CRef cr, bool strict){
 
 void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
+    if (proof != NULL) proof->remove(c);
     detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+    if (locked(c)) vardata[var(impliedLit(c))].reason = CRef_Undef;
     c.mark(1); 
     ca.free(cr);
 }
@@ -229,19 +423,98 @@ bool Solver::satisfied(const Clause& c) const {
 // Revert to the state at given level (keeping all assignment at 'level' but not beyond).
 //
 void Solver::cancelUntil(int level) {
+    for (int i = 0; i < tmp_confls.size(); i++)
+        ca.free(tmp_confls[i]);
+    tmp_confls.clear();
+
     if (decisionLevel() > level){
+        // (after chronological backtracking, literals implied at a lower level may be above 'trail_lim[level]';
+        // they stay assigned and are propagated again)
+        vec<Lit>& kept = cancel_tmp;
+        kept.clear();
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
+            if (vardata[x].level <= level){
+                kept.push(trail[c]);
+                continue; }
             assigns [x] = l_Undef;
+            if (tmp_reason[x]){
+                ca.free(vardata[x].reason);
+                tmp_reason[x] = 0; }
+            if (cards.size() > 0){
+                const std::vector<int>& os = card_occs[toInt(~trail[c])];
+                for (int i = 0; i < (int)os.size(); i++)
+                    cards[os[i]].nof_false--; }
             if (phase_saving > 1 || (phase_saving == 1 && c > trail_lim.last()))
                 polarity[x] = sign(trail[c]);
             insertVarOrder(x); }
         qhead = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        for (int i = kept.size()-1; i >= 0; i--){
+            if (cards.size() > 0)
+                trail_pos[var(kept[i])] = trail.size();
+            trail.push_(kept[i]); }
     } }
 
 
+// Reorder a conflict clause so that its first literal has the highest decision level and the second
+// the highest of the rest, and watch these two (a temporary clause, which is not attached, is only
+// reordered). With chronological backtracking the conflict level may be below the current decision level.
+int Solver::orderConflict(CRef confl, bool attached)
+{
+    Clause& c  = ca[confl];
+    if (c.size() == 1)
+        return level(var(c[0]));    // (a temporary conflict clause of a cardinality constraint)
+    int     i0 = 0, i1 = 1;
+    if (level(var(c[1])) > level(var(c[0]))){ i0 = 1; i1 = 0; }
+    for (int i = 2; i < c.size(); i++){
+        int lvl = level(var(c[i]));
+        if (lvl > level(var(c[i0]))){ i1 = i0; i0 = i; }
+        else if (lvl > level(var(c[i1]))) i1 = i; }
+
+    if (i0 > 1 || i1 > 1){
+        // (only a clause of more than two literals can get new watches)
+        if (attached) detachClause(confl, true);
+        Lit l0 = c[i0], l1 = c[i1];
+        c[i0] = c[0]; c[0] = l0;
+        if (i1 == 0) i1 = i0;
+        c[i1] = c[1]; c[1] = l1;
+        if (attached) attachClause(confl);
+    }else if (i0 == 1){
+        Lit tmp = c[0]; c[0] = c[1]; c[1] = tmp; }
+
+    return level(var(c[0]));
+}
+
+
+// The restart backtracks only to the first decision that is less active than the variable that would be
+// decided next; the decisions before it would be made again in the same order (assumptions are kept).
+int Solver::reuseTrailLevel()
+{
+    int lvl = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    if (vmtf){
+        // (with the move-to-front queue, the more recently moved decisions are kept)
+        while (vmtf_search != var_Undef && (value(vmtf_search) != l_Undef || !decision[vmtf_search]))
+            vmtf_search = vmtf_prev[vmtf_search];
+        if (vmtf_search == var_Undef)
+            return 0;
+        while (lvl < decisionLevel() && vmtf_stamp[var(trail[trail_lim[lvl]])] > vmtf_stamp[vmtf_search])
+            lvl++;
+        return lvl; }
+
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMax();
+    if (order_heap.empty())
+        return 0;
+
+    double next_act = activity[order_heap[0]];
+    while (lvl < decisionLevel() && activity[var(trail[trail_lim[lvl]])] > next_act)
+        lvl++;
+    return lvl;
+}
+
+
 //=================================================================================================
 // Major methods:
 
@@ -250,19 +523,28 @@ Lit Solver::pickBranchLit()
 {
     Var next = var_Undef;
 
-    // Random decision:
-    if (drand(random_seed) < random_var_freq && !order_heap.empty()){
-        next = order_heap[irand(random_seed,order_heap.size())];
-        if (value(next) == l_Undef && decision[next])
-            rnd_decisions++; }
-
-    // Activity based decision:
-    while (next == var_Undef || value(next) != l_Undef || !decision[next])
-        if (order_heap.empty()){
-            next = var_Undef;
-            break;
-        }else
-            next = order_heap.removeMin();
+    if (vmtf){
+        // The most recently moved unassigned variable:
+        while (vmtf_search != var_Undef && (value(vmtf_search) != l_Undef || !decision[vmtf_search]))
+            vmtf_search = vmtf_prev[vmtf_search];
+        next = vmtf_search;
+        if (next == var_Undef)
+            return lit_Undef;
+    }else{
+        // Random decision:
+        if (drand(random_seed) < random_var_freq && !order_heap.empty()){
+            next = order_heap[irand(random_seed,order_heap.size())];
+            if (value(next) == l_Undef && decision[next])
+                rnd_decisions++; }
+
+        // Activity based decision:
+        while (next == var_Undef || value(next) != l_Undef || !decision[next])
+            if (order_heap.empty()){
+                next = var_Undef;
+                break;
+            }else
+                next = order_heap.removeMax();
+    }
 
     // Choose polarity based on different polarity modes (global or per-variable):
     if (next == var_Undef)
@@ -272,7 +554,7 @@ Lit Solver::pickBranchLit()
     else if (rnd_pol)
         return mkLit(next, drand(random_seed) < 0.5);
     else
-        return mkLit(next, polarity[next]);
+        return mkLit(next, stable ? target_pol[next] : polarity[next]);
 }
 
 
@@ -302,29 +584,59 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     //
     out_learnt.push();      // (leave room for the asserting literal)
     int index   = trail.size() - 1;
+    otf_clauses.clear();
+    otf_lits.clear();
 
     do{
         assert(confl != CRef_Undef); // (otherwise should be UIP)
+        if (confl == CRef_Lazy) confl = reasonClause(var(p));
         Clause& c = ca[confl];
+        if (p != lit_Undef && c.size() == 2 && c[0] != p){
+            c[1] = c[0]; c[0] = p; }
 
-        if (c.learnt())
+        if (c.learnt()){
             claBumpActivity(c);
+            if (tiered_reduce){
+                c.used(true);
+                if ((int)c.lbd() > core_lbd){
+                    unsigned lbd = computeLBD(c, c.size());
+                    if (lbd < c.lbd())
+                        c.lbd(lbd); }
+            }
+        }
 
+        int nof_lits = 0;
         for (int j = (p == lit_Undef) ? 0 : 1; j < c.size(); j++){
             Lit q = c[j];
 
-            if (!seen[var(q)] && level(var(q)) > 0){
-                varBumpActivity(var(q));
-                seen[var(q)] = 1;
-                if (level(var(q)) >= decisionLevel())
-                    pathC++;
-                else
-                    out_learnt.push(q);
+            if (level(var(q)) > 0){
+                nof_lits++;
+                if (!seen[var(q)]){
+                    if (vmtf)
+                        vmtf_bumped.push(var(q));
+                    else
+                        varBumpActivity(var(q));
+                    seen[var(q)] = 1;
+                    if (level(var(q)) >= decisionLevel())
+                        pathC++;
+                    else
+                        out_learnt.push(q);
+                }
             }
         }
+
+        // On-the-fly strengthening: if the resolvent is the reason of 'p' without 'p', the reason
+        // can be strengthened to it. This is done after backtracking (see 'strengthenOTF()') and only
+        // when at least two literals of the strengthened clause become unassigned:
+        if (p != lit_Undef && c.learnt() && pathC > 1 && pathC + out_learnt.size() - 1 == nof_lits){
+            otf_clauses.push(confl);
+            otf_lits.push(p); }
         
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
+        // Select next clause to look at (literals of lower levels may be later on the trail after
+        // chronological backtracking):
+        do{
+            while (!seen[var(trail[index--])]);
+        }while (level(var(trail[index+1])) < decisionLevel());
         p     = trail[index+1];
         confl = reason(var(p));
         seen[var(p)] = 0;
@@ -349,7 +661,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             if (reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
+                Clause& c = ca[reasonClause(var(out_learnt[i]))];
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
@@ -381,6 +693,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     }
 
     for (int j = 0; j < analyze_toclear.size(); j++) seen[var(analyze_toclear[j])] = 0;    // ('seen[]' is now cleared)
+    if (vmtf)
+        vmtfBump();
 }
 
 
@@ -391,7 +705,7 @@ bool Solver::litRedundant(Lit p)
     assert(seen[var(p)] == seen_undef || seen[var(p)] == seen_source);
     assert(reason(var(p)) != CRef_Undef);
 
-    Clause*               c     = &ca[reason(var(p))];
+    Clause*               c     = &ca[reasonClause(var(p))];
     vec<ShrinkStackElem>& stack = analyze_stack;
     stack.clear();
 
@@ -420,7 +734,7 @@ bool Solver::litRedundant(Lit p)
             stack.push(ShrinkStackElem(i, p));
             i  = 0;
             p  = l;
-            c  = &ca[reason(var(p))];
+            c  = &ca[reasonClause(var(p))];
         }else{
             // Finished with current element 'p' and reason 'c':
             if (seen[var(p)] == seen_undef){
@@ -434,7 +748,7 @@ bool Solver::litRedundant(Lit p)
             // Continue with top element on stack:
             i  = stack.last().i;
             p  = stack.last().l;
-            c  = &ca[reason(var(p))];
+            c  = &ca[reasonClause(var(p))];
 
             stack.pop();
         }
@@ -470,7 +784,7 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
                 assert(level(x) > 0);
                 out_conflict.insert(~trail[i]);
             }else{
-                Clause& c = ca[reason(x)];
+                Clause& c = ca[reasonClause(x)];
                 for (int j = 1; j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
@@ -484,14 +798,31 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
 
 
 void Solver::uncheckedEnqueue(Lit p, CRef from)
+{
+    uncheckedEnqueue(p, decisionLevel(), from);
+}
+
+
+void Solver::uncheckedEnqueue(Lit p, int level, CRef from)
 {
     assert(value(p) == l_Undef);
+    assert(level <= decisionLevel());
     assigns[var(p)] = lbool(!sign(p));
-    vardata[var(p)] = mkVarData(from, decisionLevel());
+    vardata[var(p)] = mkVarData(from, level);
+    if (cards.size() > 0){
+        // Keep the false literal counters up to date:
+        trail_pos[var(p)] = trail.size();
+        const std::vector<int>& os = card_occs[toInt(~p)];
+        for (int i = 0; i < (int)os.size(); i++)
+            cards[os[i]].nof_false++; }
     trail.push_(p);
 }
 
 
+#ifdef MINISAT_INLINE_WATCHERS
+static const int prefetch_distance = 4;   // (how many watchers ahead 'propagate()' prefetches clauses)
+#endif
+
 /*_________________________________________________________________________________________________
 |
 |  propagate : [void]  ->  [Clause*]
@@ -510,11 +841,35 @@ CRef Solver::propagate()
 
     while (qhead < trail.size()){
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
+        int            lvl = level(var(p));      // (below 'decisionLevel()' only after chronological backtracking)
         vec<Watcher>&  ws  = watches.lookup(p);
         Watcher        *i, *j, *end;
         num_props++;
 
+        // Propagate the binary clauses first, without inspecting them:
+        vec<Watcher>&  wbin = watches_bin.lookup(p);
+        for (Watcher *b = (Watcher*)wbin, *bend = b + wbin.size(); b != bend; b++){
+            lbool val = value(b->blocker);
+            if (val == l_Undef)
+                uncheckedEnqueue(b->blocker, lvl, b->cref);
+            else if (val == l_False){
+                confl = b->cref;
+                break; }
+        }
+        if (confl != CRef_Undef){
+            qhead = trail.size();
+            break; }
+
         for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+#ifdef MINISAT_INLINE_WATCHERS
+            // Prefetch the clause a few watchers ahead unless its blocker is true (a second cache
+            // line if the clause is long):
+            if (end - i > prefetch_distance && value(i[prefetch_distance].blocker) != l_True){
+                const char* ahead = (const char*)ca.lea(i[prefetch_distance].cref);
+                __builtin_prefetch(ahead);
+                if (i[prefetch_distance].size > 14)
+                    __builtin_prefetch(ahead + 64); }
+#endif
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if (value(blocker) == l_True){
@@ -531,7 +886,7 @@ CRef Solver::propagate()
 
             // If 0th watch is true, then clause is already satisfied.
             Lit     first = c[0];
-            Watcher w     = Watcher(cr, first);
+            Watcher w     = Watcher(cr, first, c.size());
             if (first != blocker && value(first) == l_True){
                 *j++ = w; continue; }
 
@@ -543,19 +898,45 @@ CRef Solver::propagate()
                     goto NextClause; }
 
             // Did not find watch -- clause is unit under assignment:
-            *j++ = w;
             if (value(first) == l_False){
+                *j++ = w;
                 confl = cr;
                 qhead = trail.size();
                 // Copy the remaining watches:
                 while (i < end)
                     *j++ = *i++;
-            }else
-                uncheckedEnqueue(first, cr);
+            }else if (lvl == decisionLevel()){
+                *j++ = w;
+                uncheckedEnqueue(first, lvl, cr);
+            }else{
+                // Implied at the highest level of the false literals, which must be watched:
+                int max_k = 1;
+                for (int k = 2; k < c.size(); k++)
+                    if (level(var(c[k])) > level(var(c[max_k])))
+                        max_k = k;
+                if (max_k == 1)
+                    *j++ = w;
+                else{
+                    c[1] = c[max_k]; c[max_k] = false_lit;
+                    watches[~c[1]].push(w); }
+                uncheckedEnqueue(first, level(var(c[1])), cr);
+            }
 
         NextClause:;
         }
         ws.shrink(i - j);
+
+        if (confl == CRef_Undef && xor_watches[var(p)].size() > 0){
+            confl = propagateXors(var(p));
+            if (confl != CRef_Undef)
+                qhead = trail.size();
+        }
+
+        if (confl == CRef_Undef && cards.size() > 0){
+            confl = propagateCards(p);
+            if (confl != CRef_Undef)
+                qhead = trail.size();
+        }
     }
     propagations += num_props;
     simpDB_props -= num_props;
@@ -564,6 +945,201 @@ CRef Solver::propagate()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateXors : (v : Var)  ->  [Clause*]
+|  
+|  Description:
+|    Propagates the xor-clauses watching the newly assigned variable 'v'. An xor-clause watches
+|    two of its variables; when no unassigned replacement for 'v' is found, the other watched
+|    variable is implied (or, if it is assigned too, the parity is checked). Implications and
+|    conflicts are explained by temporary clauses so that 'analyze()' can treat them as usual.
+|    If a conflict arises, the conflicting clause is returned, otherwise CRef_Undef.
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateXors(Var v)
+{
+    CRef               confl = CRef_Undef;
+    std::vector<int>&  ws    = xor_watches[v];
+    int                i, j;
+
+    for (i = j = 0; i < (int)ws.size(); i++){
+        XorClause& x  = xors[ws[i]];
+        Var*       vs = xorVars(x);
+
+        // Make sure the assigned variable is vars[1]:
+        if (vs[0] == v)
+            vs[0] = vs[1], vs[1] = v;
+        assert(vs[1] == v);
+
+        // Look for new watch:
+        for (int k = 2; k < x.size; k++)
+            if (value(vs[k]) == l_Undef){
+                vs[1] = vs[k]; vs[k] = v;
+                xor_watches[vs[1]].push_back(ws[i]);
+                goto NextXor; }
+
+        // Did not find watch -- xor-clause is unit or fully assigned:
+        ws[j++] = ws[i];
+        {
+            bool parity = x.rhs;
+            int  lvl    = 0;    // (the highest level of the other variables, lower than 'decisionLevel()' only after chronological backtracking)
+            for (int k = 1; k < x.size; k++){
+                parity ^= (value(vs[k]) == l_True);
+                if (level(vs[k]) > lvl) lvl = level(vs[k]); }
+
+            if (value(vs[0]) == l_Undef){
+                uncheckedEnqueue(mkLit(vs[0], !parity), lvl, CRef_Undef);
+                if (lvl > 0){
+                    vardata[vs[0]].reason = xorExplain(x, false);
+                    tmp_reason[vs[0]] = 1; }
+                xor_propagations++;
+            }else if ((value(vs[0]) == l_True) != parity){
+                confl = xorExplain(x, true);
+                tmp_confls.push(confl);
+                xor_conflicts++;
+                // Copy the remaining watches:
+                for (i++; i < (int)ws.size(); i++)
+                    ws[j++] = ws[i];
+                break;
+            }
+        }
+    NextXor:;
+    }
+    ws.resize(j);
+
+    return confl;
+}
+
+
+// Builds the clause of the literals of 'x' that are false under the current assignment. For a
+// reason clause the first literal is the implied, true one.
+CRef Solver::xorExplain(const XorClause& x, bool conflict)
+{
+    expl_tmp.clear();
+    const Var* vs = xorVars(x);
+    for (int k = 0; k < x.size; k++){
+        Var v = vs[k];
+        expl_tmp.push(mkLit(v, (value(v) == l_True) != (k == 0 && !conflict))); }
+    return ca.alloc(expl_tmp, false);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  propagateCards : (p : Lit)  ->  [Clause*]
+|  
+|  Description:
+|    Propagates the cardinality constraints in which 'p' made a literal false or whose guard 'p'
+|    made true. The constraints keep a counter of their false literals ('uncheckedEnqueue()' and
+|    'cancelUntil()' maintain it), so each check is a comparison unless something is implied.
+|    Implications get the reason 'CRef_Lazy'; the clause is built only if conflict analysis
+|    needs it. If a conflict arises, the conflicting clause is returned, otherwise CRef_Undef.
+|________________________________________________________________________________________________@*/
+CRef Solver::propagateCards(Lit p)
+{
+    CRef confl = CRef_Undef;
+
+    const std::vector<int>& os = card_occs[toInt(~p)];
+    for (int i = 0; i < (int)os.size() && confl == CRef_Undef; i++)
+        confl = checkCard(os[i]);
+
+    const std::vector<int>& gs = card_guards[toInt(p)];
+    for (int i = 0; i < (int)gs.size() && confl == CRef_Undef; i++)
+        confl = checkCard(gs[i]);
+
+    return confl;
+}
+
+
+CRef Solver::checkCard(int i)
+{
+    CardConstraint& c     = cards[i];
+    const Lit*      lits  = cardLits(c);
+    int             slack = c.size - c.nof_false - c.bound;  // (how many more literals may become false)
+    if (slack > 0)
+        return CRef_Undef;
+
+    lbool guard = c.guard == lit_Undef ? l_True : value(c.guard);
+    if (slack < 0){
+        if (guard == l_Undef){
+            int lvl = falseLevel(c);
+            uncheckedEnqueue(~c.guard, lvl, lvl == 0 ? CRef_Undef : CRef_Lazy);
+            card_reason[var(c.guard)] = i;
+            card_propagations++;
+        }else if (guard == l_True){
+            // Conflict -- the clause of the guard and all false literals:
+            expl_tmp.clear();
+            if (c.guard != lit_Undef)
+                expl_tmp.push(~c.guard);
+            for (int k = 0; k < c.size; k++)
+                if (value(lits[k]) == l_False)
+                    expl_tmp.push(lits[k]);
+            CRef cr = ca.alloc(expl_tmp, false);
+            tmp_confls.push(cr);
+            card_conflicts++;
+            return cr;
+        }
+    }else if (guard == l_True){
+        // All the unassigned literals must be true:
+        int lvl = falseLevel(c);
+        if (c.guard != lit_Undef && level(var(c.guard)) > lvl)
+            lvl = level(var(c.guard));
+        CRef from = lvl == 0 ? CRef_Undef : CRef_Lazy;
+        for (int k = 0; k < c.size; k++)
+            if (value(lits[k]) == l_Undef){
+                uncheckedEnqueue(lits[k], lvl, from);
+                card_reason[var(lits[k])] = i;
+                card_propagations++; }
+    }
+
+    return CRef_Undef;
+}
+
+
+// The highest decision level of the false literals of a cardinality constraint: the level of its
+// implications (lower than 'decisionLevel()' only after chronological backtracking).
+int Solver::falseLevel(const CardConstraint& c) const
+{
+    const Lit* lits = cardLits(c);
+    int        lvl  = 0;
+    for (int k = 0; k < c.size; k++)
+        if (value(lits[k]) == l_False && level(var(lits[k])) > lvl)
+            lvl = level(var(lits[k]));
+    return lvl;
+}
+
+
+// Builds the reason clause of a variable implied by a cardinality constraint: the implied
+// literal, the negated guard and the literals of the constraint that were false before it.
+CRef Solver::reasonClause(Var x)
+{
+    if (reason(x) != CRef_Lazy){
+        // Binary clauses are propagated without making the implied literal the first one:
+        CRef    cr = reason(x);
+        Clause& c  = ca[cr];
+        if (c.size() == 2 && var(c[0]) != x){
+            Lit tmp = c[0]; c[0] = c[1]; c[1] = tmp; }
+        return cr; }
+
+    const CardConstraint& c    = cards[card_reason[x]];
+    const Lit*            lits = cardLits(c);
+    int                   pos  = trail_pos[x];
+    expl_tmp.clear();
+    expl_tmp.push(mkLit(x, value(x) == l_False));
+    if (c.guard != lit_Undef && var(c.guard) != x)
+        expl_tmp.push(~c.guard);
+    for (int k = 0; k < c.size; k++)
+        if (value(lits[k]) == l_False && trail_pos[var(lits[k])] < pos)
+            expl_tmp.push(lits[k]);
+
+    CRef cr = ca.alloc(expl_tmp, false);
+    vardata[x].reason = cr;
+    tmp_reason[x]     = 1;
+    card_reasons++;
+    return cr;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  reduceDB : ()  ->  [void]
@@ -571,6 +1147,10 @@ CRef Solver::propagate()
 |  Description:
 |    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
 |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    With 'tiered_reduce', the learnt clauses are kept in three tiers by their literal block distance
+|    (LBD): core clauses (LBD at most 'core_lbd') are never removed, tier-2 clauses (LBD at most
+|    'tier2_lbd') are kept if they have been used in a conflict since the previous reduction, and
+|    only the rest, the local clauses, are halved.
 |________________________________________________________________________________________________@*/
 struct reduceDB_lt { 
     ClauseAllocator& ca;
@@ -583,21 +1163,291 @@ void Solver::reduceDB()
     int     i, j;
     double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
 
-    sort(learnts, reduceDB_lt(ca));
-    // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
-    // and clauses with activity smaller than 'extra_lim':
+    // Keep the core and the used tier-2 clauses, collect the local ones:
+    vec<CRef>& local = reduce_tmp;
+    local.clear();
     for (i = j = 0; i < learnts.size(); i++){
         Clause& c = ca[learnts[i]];
-        if (c.size() > 2 && !locked(c) && (i < learnts.size() / 2 || c.activity() < extra_lim))
-            removeClause(learnts[i]);
-        else
+        if (tiered_reduce && ((int)c.lbd() <= core_lbd || ((int)c.lbd() <= tier2_lbd && c.used())))
             learnts[j++] = learnts[i];
+        else
+            local.push(learnts[i]);
+        c.used(false);
     }
     learnts.shrink(i - j);
+
+    sort(local, reduceDB_lt(ca));
+    // Don't delete binary or locked clauses. From the rest, delete clauses from the first half
+    // and clauses with activity smaller than 'extra_lim':
+    for (i = 0; i < local.size(); i++){
+        Clause& c = ca[local[i]];
+        if (c.size() > 2 && !locked(c) && (i < local.size() / 2 || c.activity() < extra_lim))
+            removeClause(local[i]);
+        else
+            learnts.push(local[i]);
+    }
     checkGarbage();
 }
 
 
+// Called at a conflict: the assignments below the conflict level are consistent.
+void Solver::updateTargetPhases()
+{
+    int assigned = trail_lim.size() == 0 ? trail.size() : trail_lim.last();
+    if (stable && assigned > target_assigned){
+        for (int i = 0; i < assigned; i++)
+            target_pol[var(trail[i])] = sign(trail[i]);
+        target_assigned = assigned; }
+    if (assigned > best_assigned){
+        for (int i = 0; i < assigned; i++)
+            best_pol[var(trail[i])] = sign(trail[i]);
+        best_assigned = assigned; }
+}
+
+
+// The rephasing cycle is: best, original, best, inverted, best, simulation (if given by 'setSimPhase()').
+void Solver::rephase()
+{
+    static const char cycle[] = { 'B', 'O', 'B', 'I', 'B', 'S' };
+    char kind = cycle[rephases % sizeof(cycle)];
+    rephases++;
+    next_rephase = conflicts + (uint64_t)rephase_first * (rephases + 1);
+
+    if ((kind == 'B' && best_assigned == 0) || (kind == 'S' && !has_sim_pol))
+        kind = 'O';
+    for (Var v = 0; v < nVars(); v++){
+        switch (kind){
+        case 'B': polarity[v] = best_pol[v]; break;
+        case 'O': polarity[v] = init_pol[v]; break;
+        case 'I': polarity[v] = !init_pol[v]; break;
+        case 'S': if (sim_pol[v] != l_Undef) polarity[v] = sim_pol[v] == l_False; break; }
+        target_pol[v] = polarity[v];
+    }
+    target_assigned = best_assigned = 0;
+}
+
+
+void Solver::switchMode()
+{
+    stable = !stable;
+    mode_switches++;
+    if (!stable)
+        mode_interval *= 2;
+    next_mode_switch = conflicts + mode_interval;
+
+    // (the target phases start from the saved ones)
+    if (stable)
+        for (Var v = 0; v < nVars(); v++)
+            target_pol[v] = polarity[v];
+    target_assigned = 0;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  inprocess : ()  ->  [bool]
+|  
+|  Description:
+|    Run an inprocessing round between restarts: vivify the core and tier-2 learnt clauses, probe
+|    the variables declared with 'setProbe()' for failed literals, and remove satisfied clauses.
+|    The round may make 'inprocess_frac' times as many propagations as the search has made since
+|    the previous round. Returns FALSE if the problem turned out unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    assert(decisionLevel() == 0);
+    if (!ok || inprocess_frac <= 0)
+        return ok;
+
+    inprocess_rounds++;
+    uint64_t budget = (uint64_t)(inprocess_frac * (propagations - inprocess_props));
+    uint64_t limit  = propagations + budget;
+    bool     ret    = vivify(propagations + budget / 2) && probeFailed(limit) && simplify();
+    inprocess_props = propagations;
+    return ret;
+}
+
+
+bool Solver::addUnit(Lit p)
+{
+    assert(decisionLevel() == 0);
+    if (value(p) == l_True)
+        return true;
+
+    if (proof != NULL){
+        vec<Lit> unit;
+        unit.push(p);
+        proof->add(unit); }
+
+    if (value(p) == l_Undef)
+        uncheckedEnqueue(p);
+    if (value(p) == l_False || propagate() != CRef_Undef){
+        if (proof != NULL) proof->addEmpty();
+        return ok = false; }
+    return true;
+}
+
+
+// Assign the literals of a clause false one by one, each at a decision level of its own. A literal
+// that is already false can be left out, and the clause can be cut after a literal that is already
+// true or after a conflict. The clause itself stays attached; it is redundant, so it may be used
+// in deriving its own shortening.
+bool Solver::vivify(uint64_t limit)
+{
+    vec<Lit>& lits = inprocess_tmp;
+    vec<Lit>  orig;
+    for (int n = learnts.size(); n > 0 && propagations < limit && withinBudget(); n--){
+        if (vivify_next >= learnts.size()) vivify_next = 0;
+        CRef cr = learnts[vivify_next++];
+        if ((int)ca[cr].lbd() > tier2_lbd || ca[cr].size() <= 2 || satisfied(ca[cr]))
+            continue;
+
+        // (propagation reorders the literals of the clause, and may build reasons and so move it)
+        int size = ca[cr].size();
+        orig.clear();
+        for (int i = 0; i < size; i++)
+            orig.push(ca[cr][i]);
+
+        lits.clear();
+        for (int i = 0; i < size; i++){
+            Lit p = orig[i];
+            if (value(p) == l_False)
+                continue;
+            lits.push(p);
+            if (value(p) == l_True)
+                break;
+            newDecisionLevel();
+            uncheckedEnqueue(~p);
+            if (propagate() != CRef_Undef)
+                break;
+        }
+        cancelUntil(0);
+        if (lits.size() == size)
+            continue;
+
+        vivified_clauses++;
+        vivified_lits += size - lits.size();
+        if (lits.size() == 1){
+            bool unit_ok = addUnit(lits[0]);
+            removeClause(cr);
+            learnts[--vivify_next] = learnts.last();
+            learnts.pop();
+            if (!unit_ok)
+                return false;
+        }else{
+            if (proof != NULL){
+                proof->add(lits);
+                proof->remove(ca[cr]); }
+            detachClause(cr, true);
+            Clause& c = ca[cr];
+            for (int i = 0; i < lits.size(); i++)
+                c[i] = lits[i];
+            c.shrink(c.size() - lits.size());
+            if ((int)c.lbd() > lits.size())
+                c.lbd(lits.size());
+            attachClause(cr);
+        }
+    }
+    return true;
+}
+
+
+// Assign a variable true and false in turn. If one fails, the other is a unit, and a literal implied
+// by both is a unit as well.
+bool Solver::probeFailed(uint64_t limit)
+{
+    vec<Lit>& implied = inprocess_tmp;
+    vec<Lit>  bin;
+    for (int n = probe_vars.size(); n > 0 && propagations < limit && withinBudget(); n--){
+        if (probe_next >= probe_vars.size()) probe_next = 0;
+        Var v = probe_vars[probe_next++];
+        if (!probe[v] || !decision[v] || value(v) != l_Undef)
+            continue;
+
+        Lit failed = lit_Undef;
+        implied.clear();
+        for (int b = 0; b < 2 && failed == lit_Undef; b++){
+            newDecisionLevel();
+            uncheckedEnqueue(mkLit(v, b));
+            if (propagate() != CRef_Undef)
+                failed = mkLit(v, b);
+            else if (b == 0)
+                for (int i = trail_lim[0] + 1; i < trail.size(); i++)
+                    implied.push(trail[i]);
+            else{
+                int i, j;
+                for (i = j = 0; i < implied.size(); i++)
+                    if (value(implied[i]) == l_True)
+                        implied[j++] = implied[i];
+                implied.shrink(i - j);
+            }
+            cancelUntil(0);
+        }
+
+        if (failed != lit_Undef){
+            probe_units++;
+            if (!addUnit(~failed))
+                return false;
+            continue; }
+
+        for (int i = 0; i < implied.size(); i++){
+            Lit q = implied[i];
+            if (value(q) != l_Undef)
+                continue;
+            // (the unit is not RUP by itself, derive it from the two implications)
+            if (proof != NULL){
+                bin.clear(); bin.push(~mkLit(v)); bin.push(q); proof->add(bin);
+                bin[0] = mkLit(v);                             proof->add(bin); }
+            probe_units++;
+            bool unit_ok = addUnit(q);
+            if (proof != NULL){
+                proof->remove(bin);
+                bin[0] = ~mkLit(v); proof->remove(bin); }
+            if (!unit_ok)
+                return false;
+        }
+    }
+    return true;
+}
+
+
+// Replace each clause found by 'analyze()' by the resolvent it was found to be subsumed by. Called
+// after backtracking, when at least two literals of the resolvent are unassigned.
+void Solver::strengthenOTF()
+{
+    vec<Lit>& lits = inprocess_tmp;
+    for (int i = 0; i < otf_clauses.size(); i++){
+        CRef          cr = otf_clauses[i];
+        const Clause& c  = ca[cr];
+        int           nof_free = 0;
+        lits.clear();
+        for (int j = 0; j < c.size(); j++){
+            if (c[j] == otf_lits[i] || (value(c[j]) == l_False && level(var(c[j])) == 0))
+                continue;
+            lits.push(c[j]);
+            if (value(c[j]) == l_Undef){
+                lits.last() = lits[nof_free];
+                lits[nof_free++] = c[j]; }
+        }
+        if (nof_free < 2)
+            continue;
+
+        if (proof != NULL){
+            proof->add(lits);
+            proof->remove(c); }
+        detachClause(cr, true);
+        Clause& d = ca[cr];
+        for (int j = 0; j < lits.size(); j++)
+            d[j] = lits[j];
+        d.shrink(d.size() - lits.size());
+        if ((int)d.lbd() > lits.size())
+            d.lbd(lits.size());
+        attachClause(cr);
+        otf_strengthened++;
+    }
+}
+
+
 void Solver::removeSatisfied(vec<CRef>& cs)
 {
     int i, j;
@@ -608,11 +1458,28 @@ void Solver::removeSatisfied(vec<CRef>& cs)
         else{
             // Trim clause:
             assert(value(c[0]) == l_Undef && value(c[1]) == l_Undef);
+            if (proof != NULL){
+                int k = 2;
+                while (k < c.size() && value(c[k]) != l_False) k++;
+                if (k < c.size()){
+                    expl_tmp.clear();
+                    for (k = 0; k < c.size(); k++)
+                        if (value(c[k]) != l_False)
+                            expl_tmp.push(c[k]);
+                    proof->add(expl_tmp);
+                    proof->remove(c); } }
+            // A clause trimmed into a binary one moves to the binary watches:
+            int n_false = 0;
+            for (int k = 2; k < c.size(); k++)
+                if (value(c[k]) == l_False) n_false++;
+            bool rewatch = c.size() > 2 && c.size() - n_false == 2;
+            if (rewatch) detachClause(cs[i], true);
             for (int k = 2; k < c.size(); k++)
                 if (value(c[k]) == l_False){
                     c[k--] = c[c.size()-1];
                     c.pop();
                 }
+            if (rewatch) attachClause(cs[i]);
             cs[j++] = cs[i];
         }
     }
@@ -620,13 +1487,220 @@ void Solver::removeSatisfied(vec<CRef>& cs)
 }
 
 
+// Removes top-level assigned variables from the xor-clauses, compacts 'xor_vars' and rebuilds
+// the xor watches.
+bool Solver::simplifyXors()
+{
+    int i, j, n = 0;
+    for (i = j = 0; i < xors.size(); i++){
+        XorClause x = xors[i];
+        int first = n;
+        for (int k = 0; k < x.size; k++){
+            Var v = xor_vars[x.first + k];
+            if (value(v) == l_Undef)
+                xor_vars[n++] = v;
+            else
+                x.rhs ^= (value(v) == l_True); }
+        x.first = first;
+        x.size  = n - first;
+
+        if (x.size == 0){
+            if (x.rhs) return false;
+        }else if (x.size == 1){
+            // (cannot happen after a complete propagation, but be safe)
+            uncheckedEnqueue(mkLit(xor_vars[first], !x.rhs));
+            n = first;
+        }else
+            xors[j++] = x;
+    }
+    num_xors -= i - j;
+    xors.shrink(i - j);
+    xor_vars.shrink(xor_vars.size() - n);
+
+    for (int v = 0; v < (int)xor_watches.size(); v++)
+        xor_watches[v].clear();
+    for (int i = 0; i < xors.size(); i++){
+        xor_watches[xorVars(xors[i])[0]].push_back(i);
+        xor_watches[xorVars(xors[i])[1]].push_back(i); }
+
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  gaussJordan : [void]  ->  [bool]
+|  
+|  Description:
+|    Brings the system of xor-clauses into reduced row echelon form over packed bit rows. An
+|    inconsistent row makes the problem unsatisfiable (FALSE is returned), rows with a single
+|    variable give top-level units and rows with two variables give equivalences, which are added
+|    as new xor-clauses. The original xor-clauses are kept as they are. Assumes that 'simplifyXors()'
+|    has just been called.
+|________________________________________________________________________________________________@*/
+bool Solver::gaussJordan()
+{
+    // Number the variables of the xor-clauses as the columns of the matrix:
+    vec<int> col(nVars(), -1);
+    vec<Var> col_var;
+    for (int i = 0; i < xors.size(); i++)
+        for (int k = 0; k < xors[i].size; k++){
+            Var v = xorVars(xors[i])[k];
+            if (col[v] == -1){
+                col[v] = col_var.size();
+                col_var.push(v); } }
+
+    int rows  = xors.size();
+    int cols  = col_var.size();
+    int words = (cols + 1 + 63) / 64;    // (the last column is the right-hand side)
+    if (rows == 0 || (double)rows * (cols + 1) > gauss_max_cells)
+        return true;
+    gauss_runs++;
+
+    vec<uint64_t> m(rows * words, 0);
+    for (int r = 0; r < rows; r++){
+        uint64_t* row = &m[r * words];
+        for (int k = 0; k < xors[r].size; k++){
+            int c = col[xorVars(xors[r])[k]];
+            row[c >> 6] ^= (uint64_t)1 << (c & 63); }
+        if (xors[r].rhs)
+            row[cols >> 6] |= (uint64_t)1 << (cols & 63);
+    }
+
+    // Eliminate; the rows below 'rank' are zero on the columns processed so far:
+    int rank = 0;
+    for (int c = 0; c < cols && rank < rows; c++){
+        int      w   = c >> 6;
+        uint64_t bit = (uint64_t)1 << (c & 63);
+        int      piv = rank;
+        while (piv < rows && !(m[piv * words + w] & bit)) piv++;
+        if (piv == rows) continue;
+
+        if (piv != rank)
+            for (int k = w; k < words; k++){
+                uint64_t tmp = m[piv * words + k];
+                m[piv * words + k]  = m[rank * words + k];
+                m[rank * words + k] = tmp; }
+
+        const uint64_t* prow = &m[rank * words];
+        for (int r = 0; r < rows; r++)
+            if (r != rank && (m[r * words + w] & bit)){
+                uint64_t* row = &m[r * words];
+                for (int k = w; k < words; k++)
+                    row[k] ^= prow[k]; }
+        rank++;
+    }
+
+    // Inspect the rows:
+    uint64_t rhs_mask = (uint64_t)1 << (cols & 63);
+    for (int r = 0; r < rows; r++){
+        const uint64_t* row = &m[r * words];
+        bool            rhs = (row[cols >> 6] & rhs_mask) != 0;
+        Var             vs[2];
+        int             n   = 0;
+        for (int k = 0; k < words && n <= 2; k++){
+            uint64_t bits = row[k];
+            if (k == cols >> 6) bits &= ~rhs_mask;
+            for (; bits != 0 && n <= 2; bits &= bits - 1){
+                int c = k * 64;
+                for (uint64_t b = bits & (~bits + 1); b != 1; b >>= 1) c++;
+                if (n < 2) vs[n] = col_var[c];
+                n++; }
+        }
+
+        if (n == 0){
+            if (rhs) return false;
+        }else if (n == 1){
+            Lit p = mkLit(vs[0], !rhs);
+            if (value(p) == l_False) return false;
+            if (value(p) == l_Undef){
+                uncheckedEnqueue(p);
+                gauss_units++; }
+        }else if (n == 2 && value(vs[0]) == l_Undef && value(vs[1]) == l_Undef){
+            uint64_t key = vs[0] < vs[1] ? ((uint64_t)vs[0] << 32 | vs[1]) : ((uint64_t)vs[1] << 32 | vs[0]);
+            if (!gauss_derived.has(key)){
+                gauss_derived.insert(key, rhs);
+                vec<Var> eq; eq.push(vs[0]); eq.push(vs[1]);
+                addXor_(eq, rhs);
+                gauss_equivs++; }
+        }
+    }
+
+    return true;
+}
+
+
 void Solver::rebuildOrderHeap()
 {
+    if (vmtf){
+        vmtf_search = vmtf_last;
+        return; }
+
     vec<Var> vs;
     for (Var v = 0; v < nVars(); v++)
         if (decision[v] && value(v) == l_Undef)
             vs.push(v);
-    order_heap.build(vs);
+    order_heap.build(vs, activity);
+}
+
+
+void Solver::vmtfEnqueue(Var v)
+{
+    vmtf_prev[v] = vmtf_last;
+    vmtf_next[v] = var_Undef;
+    if (vmtf_last != var_Undef) vmtf_next[vmtf_last] = v;
+    else                        vmtf_first = v;
+    vmtf_last     = v;
+    vmtf_stamp[v] = ++vmtf_time;
+}
+
+
+void Solver::vmtfDequeue(Var v)
+{
+    Var p = vmtf_prev[v], n = vmtf_next[v];
+    if (p != var_Undef) vmtf_next[p] = n;
+    else                vmtf_first = n;
+    if (n != var_Undef) vmtf_prev[n] = p;
+    else                vmtf_last = p;
+}
+
+
+struct VmtfStampLt {
+    const VMap<uint64_t>& stamp;
+    VmtfStampLt(const VMap<uint64_t>& s) : stamp(s) {}
+    bool operator () (Var x, Var y) const { return stamp[x] < stamp[y]; }
+};
+void Solver::vmtfBump()
+{
+    // (the variables keep their relative order, and the search position is updated as they get unassigned)
+    sort(vmtf_bumped, VmtfStampLt(vmtf_stamp));
+    for (int i = 0; i < vmtf_bumped.size(); i++){
+        Var v = vmtf_bumped[i];
+        if (v != vmtf_last){
+            vmtfDequeue(v);
+            vmtfEnqueue(v); }
+    }
+    vmtf_bumped.clear();
+}
+
+
+// The most active variables come to the front (ties are broken by the variable order, like in the heap).
+struct VmtfActLt {
+    const VMap<double>& act;
+    VmtfActLt(const VMap<double>& a) : act(a) {}
+    bool operator () (Var x, Var y) const { return act[x] < act[y] || (act[x] == act[y] && x > y); }
+};
+void Solver::vmtfSort()
+{
+    vec<Var> vs;
+    for (Var v = 0; v < nVars(); v++)
+        vs.push(v);
+    sort(vs, VmtfActLt(activity));
+    vmtf_first = vmtf_last = var_Undef;
+    for (int i = 0; i < vs.size(); i++)
+        vmtfEnqueue(vs[i]);
+    vmtf_search = vmtf_last;
+    vmtf_sorted = true;
 }
 
 
@@ -642,12 +1716,23 @@ bool Solver::simplify()
 {
     assert(decisionLevel() == 0);
 
-    if (!ok || propagate() != CRef_Undef)
-        return ok = false;
+    if (!ok) return false;
+    if (propagate() != CRef_Undef){
+        if (proof != NULL) proof->addEmpty();
+        return ok = false; }
 
     if (nAssigns() == simpDB_assigns || (simpDB_props > 0))
         return true;
 
+    // Simplify the xor-clauses and derive new facts from them:
+    if (xors.size() > 0){
+        if (!simplifyXors() || (gauss && !gaussJordan()) || propagate() != CRef_Undef)
+            return ok = false;
+        // (propagated units may have left some xor-clauses with assigned variables)
+        if (!simplifyXors())
+            return ok = false;
+    }
+
     // Remove satisfied clauses:
     removeSatisfied(learnts);
     if (remove_satisfied){       // Can be turned off.
@@ -707,28 +1792,60 @@ lbool Solver::search(int nof_conflicts)
     vec<Lit>    learnt_clause;
     starts++;
 
+    bool        chrono = chrono_backtrack >= 0;
+
     for (;;){
         CRef confl = propagate();
         if (confl != CRef_Undef){
             // CONFLICT
             conflicts++; conflictC++;
-            if (decisionLevel() == 0) return l_False;
+            if (chrono && decisionLevel() > 0){
+                // (a temporary conflict clause of an xor-clause or a cardinality constraint is not
+                // attached, and it must survive the backtracking)
+                bool tmp = tmp_confls.size() > 0 && tmp_confls.last() == confl;
+                if (tmp) tmp_confls.pop();
+                int confl_level = orderConflict(confl, !tmp);
+                if (confl_level > 0 && ca[confl].size() > 1 && level(var(ca[confl][1])) < confl_level){
+                    // A missed implication: the clause was unit at a lower level.
+                    Lit p = ca[confl][0];
+                    cancelUntil(confl_level - 1);
+                    uncheckedEnqueue(p, level(var(ca[confl][1])), confl);
+                    if (tmp) tmp_reason[var(p)] = 1;
+                    missed_implications++;
+                    continue; }
+                cancelUntil(confl_level);
+                if (tmp) tmp_confls.push(confl);
+            }
+            if (decisionLevel() == 0){
+                if (proof != NULL) proof->addEmpty();
+                return l_False; }
 
+            updateTargetPhases();
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
-            cancelUntil(backtrack_level);
+            unsigned lbd = computeLBD(learnt_clause, learnt_clause.size());
+            if (chrono && learnt_clause.size() > 1 && decisionLevel() - backtrack_level > chrono_backtrack){
+                cancelUntil(decisionLevel() - 1);
+                chrono_backtracks++;
+            }else
+                cancelUntil(backtrack_level);
+            if (proof != NULL) proof->add(learnt_clause);
+            if (otf_clauses.size() > 0)
+                strengthenOTF();
 
             if (learnt_clause.size() == 1){
                 uncheckedEnqueue(learnt_clause[0]);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
+                ca[cr].lbd(lbd);
                 learnts.push(cr);
                 attachClause(cr);
                 claBumpActivity(ca[cr]);
-                uncheckedEnqueue(learnt_clause[0], cr);
+                uncheckedEnqueue(learnt_clause[0], backtrack_level, cr);
             }
 
-            varDecayActivity();
+            if (!vmtf)
+                varDecayActivity();
             claDecayActivity();
 
             if (--learntsize_adjust_cnt == 0){
@@ -740,7 +1857,7 @@ lbool Solver::search(int nof_conflicts)
                     printf("| %9d | %7d %8d %8d | %8d %8d %6.0f | %6.3f %% |\n", 
                            (int)conflicts, 
                            (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]), nClauses(), (int)clauses_literals, 
-                           (int)max_learnts, nLearnts(), (double)learnts_literals/nLearnts(), progressEstimate()*100);
+                           tiered_reduce ? (int)next_reduce : (int)max_learnts, nLearnts(), (double)learnts_literals/nLearnts(), progressEstimate()*100);
             }
 
         }else{
@@ -748,16 +1865,24 @@ lbool Solver::search(int nof_conflicts)
             if ((nof_conflicts >= 0 && conflictC >= nof_conflicts) || !withinBudget()){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                int restart_level = reuse_trail ? reuseTrailLevel() : 0;
+                if (restart_level > 0){
+                    reused_trails++;
+                    reused_levels += restart_level; }
+                cancelUntil(restart_level);
                 return l_Undef; }
 
             // Simplify the set of problem clauses:
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
-            if (learnts.size()-nAssigns() >= max_learnts)
+            if (tiered_reduce ? conflicts >= next_reduce : learnts.size()-nAssigns() >= max_learnts){
                 // Reduce the set of learnt clauses:
                 reduceDB();
+                if (tiered_reduce){
+                    reduce_interval += inc_reduce;
+                    next_reduce      = conflicts + reduce_interval; }
+                inprocess_pending = true; }
 
             Lit next = lit_Undef;
             while (decisionLevel() < assumptions.size()){
@@ -843,11 +1968,31 @@ lbool Solver::solve_()
     if (!ok) return l_False;
 
     solves++;
-
-    max_learnts = nClauses() * learntsize_factor;
+    checkpoint_next = cpuTime() + checkpoint_interval;
+
+    if (vmtf && !vmtf_sorted)
+        vmtfSort();
+
+    // (an xor-clause counts as the clauses of its CNF encoding, a cardinality constraint
+    // as its number of literals)
+    double nof_clauses = nClauses();
+    for (int i = 0; i < xors.size(); i++)
+        nof_clauses += pow(2, xors[i].size < 10 ? xors[i].size - 1 : 9);
+    for (int i = 0; i < cards.size(); i++)
+        nof_clauses += cards[i].size;
+    max_learnts = nof_clauses * learntsize_factor;
     if (max_learnts < min_learnts_lim)
         max_learnts = min_learnts_lim;
 
+    // (the reduction, mode and rephasing schedules carry over to later calls)
+    if (reduce_interval == 0){
+        reduce_interval = first_reduce;
+        next_reduce     = conflicts + reduce_interval; }
+    if (mode_interval == 0){
+        mode_interval    = mode_first;
+        next_mode_switch = conflicts + mode_interval;
+        next_rephase     = conflicts + rephase_first; }
+
     learntsize_adjust_confl   = learntsize_adjust_start_confl;
     learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
     lbool   status            = l_Undef;
@@ -855,17 +2000,48 @@ lbool Solver::solve_()
     if (verbosity >= 1){
         printf("============================[ Search Statistics ]==============================\n");
         printf("| Conflicts |          ORIGINAL         |          LEARNT          | Progress |\n");
-        printf("|           |    Vars  Clauses Literals |    Limit  Clauses Lit/Cl |          |\n");
+        printf("|           |    Vars  Clauses Literals |   %s  Clauses Lit/Cl |          |\n", tiered_reduce ? "Reduce" : " Limit");
         printf("===============================================================================\n");
     }
 
-    // Search:
-    int curr_restarts = 0;
+    // Search (the restart sequences of the two modes are separate and start anew in each call,
+    // except that the first call of a solver restored from a checkpoint continues them):
+    if (solves > 1)
+        focused_restarts = stable_restarts = 0;
     while (status == l_Undef){
-        double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
-        status = search(rest_base * restart_first);
+        int&   curr_restarts = stable ? stable_restarts : focused_restarts;
+        double rest_base     = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
+        double nof_conflicts = rest_base * (stable ? stable_restart_first : restart_first);
+        if (stable_mode && next_mode_switch > conflicts && nof_conflicts > next_mode_switch - conflicts)
+            nof_conflicts = next_mode_switch - conflicts;
+
+        uint64_t prev_conflicts = conflicts, prev_decisions = decisions, prev_propagations = propagations;
+        status = search(nof_conflicts);
+        if (stable){
+            stable_conflicts    += conflicts    - prev_conflicts;
+            stable_decisions    += decisions    - prev_decisions;
+            stable_propagations += propagations - prev_propagations; }
         if (!withinBudget()) break;
         curr_restarts++;
+
+        if (status == l_Undef && stable_mode && conflicts >= next_mode_switch)
+            switchMode();
+        if (status == l_Undef && stable_mode && conflicts >= next_rephase)
+            rephase();
+
+        if (status == l_Undef && inprocess_pending){
+            inprocess_pending = false;
+            cancelUntil(0);
+            if (!inprocess())
+                status = l_False; }
+
+        if (status == l_Undef && checkpoint_file != NULL && cpuTime() >= checkpoint_next){
+            // (a restart may have kept a part of the trail)
+            cancelUntil(0);
+            if (!writeCheckpoint(checkpoint_file))
+                fprintf(stderr, "WARNING! Could not write the checkpoint file %s\n", checkpoint_file);
+            checkpoint_next = cpuTime() + checkpoint_interval;
+        }
     }
 
     if (verbosity >= 1)
@@ -910,6 +2086,23 @@ bool Solver::implies(const vec<Lit>& assumps, vec<Lit>& out)
     return ret;
 }
 
+
+void Solver::exportLearnts(vec<Lit>& out, int max_size) const
+{
+    int units = trail_lim.size() == 0 ? trail.size() : trail_lim[0];
+    for (int i = 0; i < units; i++){
+        out.push(trail[i]);
+        out.push(lit_Undef); }
+
+    for (int i = 0; i < learnts.size(); i++){
+        const Clause& c = ca[learnts[i]];
+        if (c.size() > max_size || satisfied(c))
+            continue;
+        for (int j = 0; j < c.size(); j++)
+            out.push(c[j]);
+        out.push(lit_Undef); }
+}
+
 //=================================================================================================
 // Writing CNF to DIMACS:
 // 
@@ -997,11 +2190,362 @@ void Solver::printStats() const
     printf("decisions             : %-12" PRIu64"   (%4.2f %% random) (%.0f /sec)\n", decisions, (float)rnd_decisions*100 / (float)decisions, decisions   /cpu_time);
     printf("propagations          : %-12" PRIu64"   (%.0f /sec)\n", propagations, propagations/cpu_time);
     printf("conflict literals     : %-12" PRIu64"   (%4.2f %% deleted)\n", tot_literals, (max_literals - tot_literals)*100 / (double)max_literals);
+    if (num_xors > 0 || gauss_runs > 0){
+        printf("xor propagations      : %-12" PRIu64"   (%" PRIu64" conflicts)\n", xor_propagations, xor_conflicts);
+        printf("gauss-jordan          : %-12" PRIu64"   (%" PRIu64" units, %" PRIu64" equivalences)\n", gauss_runs, gauss_units, gauss_equivs); }
+    if (num_cards > 0)
+        printf("card propagations     : %-12" PRIu64"   (%" PRIu64" conflicts, %" PRIu64" reasons built)\n", card_propagations, card_conflicts, card_reasons);
+    if (mode_switches > 0)
+        printf("mode switches         : %-12" PRIu64"   (stable: %" PRIu64" conflicts, %" PRIu64" decisions, %" PRIu64" propagations)\n", mode_switches, stable_conflicts, stable_decisions, stable_propagations);
+    if (rephases > 0)
+        printf("rephases              : %-12" PRIu64"\n", rephases);
+    if (inprocess_rounds > 0)
+        printf("inprocessing          : %-12" PRIu64"   (%" PRIu64" vivified, %" PRIu64" lits removed, %" PRIu64" probe units)\n", inprocess_rounds, vivified_clauses, vivified_lits, probe_units);
+    if (otf_strengthened > 0)
+        printf("otf strengthened      : %-12" PRIu64"\n", otf_strengthened);
+    if (chrono_backtracks > 0 || missed_implications > 0)
+        printf("chrono backtracks     : %-12" PRIu64"   (%" PRIu64" missed implications)\n", chrono_backtracks, missed_implications);
+    if (reused_trails > 0)
+        printf("reused trails         : %-12" PRIu64"   (%" PRIu64" decision levels kept)\n", reused_trails, reused_levels);
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
     printf("CPU time              : %g s\n", cpu_time);
 }
 
 
+//=================================================================================================
+// Proof logging:
+
+
+bool Solver::openProof(const char* file)
+{
+    assert(nClauses() == 0 && nLearnts() == 0);
+    if (proof == NULL) proof = new DratWriter();
+    return proof->open(file);
+}
+
+
+bool Solver::closeProof()
+{
+    if (proof == NULL) return true;
+    bool ret = proof->close();
+    delete proof;
+    proof = NULL;
+    return ret;
+}
+
+
+//=================================================================================================
+// Checkpointing:
+
+
+static const char checkpoint_magic[8] = {'M','S','C','K','P','T','0','5'};
+
+long Solver::rawLeft(FILE* f) const
+{
+    long pos = ftell(f);
+    if (pos < 0 || fseek(f, 0, SEEK_END) != 0)
+        return 0;
+    long end = ftell(f);
+    return fseek(f, pos, SEEK_SET) == 0 && end > pos ? end - pos : 0;
+}
+
+bool Solver::writeCheckpoint(const char* file)
+{
+    assert(decisionLevel() == 0);
+
+    // Write to a temporary file that replaces the old checkpoint only when complete:
+    vec<char> tmp_file;
+    for (const char* c = file; *c; c++) tmp_file.push(*c);
+    for (const char* c = ".tmp"; *c; c++) tmp_file.push(*c);
+    tmp_file.push('\0');
+
+    FILE* f = fopen((char*)tmp_file, "wb");
+    if (f == NULL)
+        return false;
+
+    fwrite(checkpoint_magic, 1, sizeof(checkpoint_magic), f);
+    writeRaw(f, (uint32_t)checkpoint_data.size());
+    fwrite((const char*)checkpoint_data, 1, checkpoint_data.size(), f);
+    bool written = writeState(f) && !ferror(f);
+    written      = (fclose(f) == 0) && written;
+
+    if (written && ::rename((char*)tmp_file, file) == 0){
+        if (verbosity >= 1)
+            printf("| Wrote checkpoint %s (%d clauses, %d learnts)\n", file, nClauses(), nLearnts());
+        return true; }
+
+    ::remove((char*)tmp_file);
+    return false;
+}
+
+
+bool Solver::readCheckpoint(const char* file)
+{
+    assert(nVars() == 0 && decisionLevel() == 0);
+
+    FILE* f = fopen(file, "rb");
+    if (f == NULL)
+        return false;
+
+    char     magic[sizeof(checkpoint_magic)];
+    uint32_t size;
+    bool     success = fread(magic, 1, sizeof(magic), f) == sizeof(magic)
+                    && memcmp(magic, checkpoint_magic, sizeof(magic)) == 0
+                    && readRaw(f, size)
+                    && size <= (uint32_t)rawLeft(f);
+    if (success){
+        checkpoint_data.growTo(size);
+        success = fread((char*)checkpoint_data, 1, size, f) == size
+               && readState(f); }
+
+    fclose(f);
+    return success;
+}
+
+
+void Solver::writeClauses(FILE* f, const vec<CRef>& cs)
+{
+    int n = 0;
+    for (int i = 0; i < cs.size(); i++)
+        if (ca[cs[i]].mark() != 1)
+            n++;
+    writeRaw(f, (int32_t)n);
+
+    for (int i = 0; i < cs.size(); i++){
+        Clause& c = ca[cs[i]];
+        if (c.mark() == 1) continue;
+        writeRaw(f, (int32_t)c.size());
+        writeRaw(f, c.learnt() ? c.activity() : 0.0f);
+        writeRaw(f, (int32_t)(c.learnt() ? c.lbd() : 0));
+        for (int j = 0; j < c.size(); j++)
+            writeRaw(f, (int32_t)toInt(c[j]));
+    }
+}
+
+
+bool Solver::writeState(FILE* f)
+{
+    writeRaw(f, (char)ok);
+    writeRaw(f, (int32_t)nVars());
+    writeRaw(f, cla_inc);
+    writeRaw(f, var_inc);
+    writeRaw(f, starts);
+    writeRaw(f, conflicts);
+    writeRaw(f, decisions);
+    writeRaw(f, propagations);
+    writeRaw(f, next_reduce);
+    writeRaw(f, (int32_t)reduce_interval);
+    writeRaw(f, (char)stable);
+    writeRaw(f, next_mode_switch);
+    writeRaw(f, mode_interval);
+    writeRaw(f, next_rephase);
+    writeRaw(f, rephases);
+    writeRaw(f, (int32_t)target_assigned);
+    writeRaw(f, (int32_t)best_assigned);
+    writeRaw(f, (char)vmtf);
+    writeRaw(f, (char)stable_mode);
+    writeRaw(f, (char)tiered_reduce);
+    writeRaw(f, (int32_t)chrono_backtrack);
+    writeRaw(f, (char)reuse_trail);
+    writeRaw(f, inprocess_frac);
+    writeRaw(f, (int32_t)focused_restarts);
+    writeRaw(f, (int32_t)stable_restarts);
+    writeRaw(f, (int32_t)probe_next);
+    writeRaw(f, (int32_t)vivify_next);
+    writeRaw(f, inprocess_props);
+
+    // Heuristic state:
+    for (Var v = 0; v < nVars(); v++){
+        writeRaw(f, activity[v]);
+        writeRaw(f, polarity[v]);
+        writeRaw(f, (char)toInt(user_pol[v]));
+        writeRaw(f, decision[v]);
+        writeRaw(f, init_pol[v]);
+        writeRaw(f, (char)toInt(sim_pol[v]));
+        writeRaw(f, target_pol[v]);
+        writeRaw(f, best_pol[v]);
+        writeRaw(f, vmtf_stamp[v]);
+        writeRaw(f, probe[v]); }
+    writeRaw(f, (int32_t)probe_vars.size());
+    for (int i = 0; i < probe_vars.size(); i++)
+        writeRaw(f, (int32_t)probe_vars[i]);
+
+    // Top-level assignments:
+    int n = trail_lim.size() == 0 ? trail.size() : trail_lim[0];
+    writeRaw(f, (int32_t)n);
+    for (int i = 0; i < n; i++)
+        writeRaw(f, (int32_t)toInt(trail[i]));
+
+    writeClauses(f, clauses);
+    writeClauses(f, learnts);
+
+    writeRaw(f, (int32_t)xors.size());
+    for (int i = 0; i < xors.size(); i++){
+        writeRaw(f, (char)xors[i].rhs);
+        writeRaw(f, (int32_t)xors[i].size);
+        for (int j = 0; j < xors[i].size; j++)
+            writeRaw(f, (int32_t)xorVars(xors[i])[j]); }
+
+    writeRaw(f, (int32_t)cards.size());
+    for (int i = 0; i < cards.size(); i++){
+        writeRaw(f, (int32_t)toInt(cards[i].guard));
+        writeRaw(f, (int32_t)cards[i].bound);
+        writeRaw(f, (int32_t)cards[i].size);
+        for (int j = 0; j < cards[i].size; j++)
+            writeRaw(f, (int32_t)toInt(cardLits(cards[i])[j])); }
+
+    return true;
+}
+
+
+bool Solver::readState(FILE* f)
+{
+    char    was_ok;
+    int32_t n, m, x, lbd, tgt, best;
+    int32_t chrono, f_restarts, s_restarts, p_next, v_next;
+    char    stb, use_vmtf, use_stable, use_tiered, use_reuse;
+    float   act;
+    if (!readRaw(f, was_ok) || !readRaw(f, n) ||
+        !readRaw(f, cla_inc) || !readRaw(f, var_inc) ||
+        !readRaw(f, starts) || !readRaw(f, conflicts) || !readRaw(f, decisions) || !readRaw(f, propagations) ||
+        !readRaw(f, next_reduce) || !readRaw(f, reduce_interval) ||
+        !readRaw(f, stb) || !readRaw(f, next_mode_switch) || !readRaw(f, mode_interval) ||
+        !readRaw(f, next_rephase) || !readRaw(f, rephases) || !readRaw(f, tgt) || !readRaw(f, best) || !readRaw(f, use_vmtf) ||
+        !readRaw(f, use_stable) || !readRaw(f, use_tiered) || !readRaw(f, chrono) || !readRaw(f, use_reuse) ||
+        !readRaw(f, inprocess_frac) || !readRaw(f, f_restarts) || !readRaw(f, s_restarts) ||
+        !readRaw(f, p_next) || !readRaw(f, v_next) || !readRaw(f, inprocess_props))
+        return false;
+    if (n < 0 || n > rawLeft(f))
+        return false;
+    stable           = stb;
+    target_assigned  = tgt;
+    best_assigned    = best;
+    vmtf             = use_vmtf;
+    stable_mode      = use_stable;
+    tiered_reduce    = use_tiered;
+    chrono_backtrack = chrono;
+    reuse_trail      = use_reuse;
+    focused_restarts = f_restarts;
+    stable_restarts  = s_restarts;
+    probe_next       = p_next;
+    vivify_next      = v_next;
+
+    for (Var v = 0; v < n; v++){
+        double a; char pol, upol, dec, ipol, spol, tpol, bpol, prb; uint64_t stamp;
+        if (!readRaw(f, a) || !readRaw(f, pol) || !readRaw(f, upol) || !readRaw(f, dec) ||
+            !readRaw(f, ipol) || !readRaw(f, spol) || !readRaw(f, tpol) || !readRaw(f, bpol) || !readRaw(f, stamp) ||
+            !readRaw(f, prb))
+            return false;
+        newVar(toLbool(upol), dec);
+        setActivity(v, a);
+        polarity[v]   = pol;
+        init_pol[v]   = ipol;
+        target_pol[v] = tpol;
+        best_pol[v]   = bpol;
+        if (toLbool(spol) != l_Undef)
+            setSimPhase(v, toLbool(spol) == l_True);
+        vmtf_stamp[v] = stamp;
+        probe[v]      = prb; }
+
+    // The probed variables in the order of their declaration:
+    if (!readRaw(f, n) || n < 0 || n > rawLeft(f)) return false;
+    for (int i = 0; i < n; i++){
+        if (!readRaw(f, x) || x < 0 || x >= nVars()) return false;
+        probe_vars.push(x); }
+
+    // The move-to-front queue in the order of the stamps:
+    if (vmtf){
+        vec<Var> vs;
+        for (Var v = 0; v < nVars(); v++)
+            vs.push(v);
+        sort(vs, VmtfStampLt(vmtf_stamp));
+        vmtf_first = vmtf_last = var_Undef;
+        for (int i = 0; i < vs.size(); i++)
+            vmtfEnqueue(vs[i]);
+        vmtf_search = vmtf_last;
+        vmtf_sorted = true; }
+
+    // Top-level assignments:
+    if (!readRaw(f, n)) return false;
+    for (int i = 0; i < n; i++){
+        if (!readRaw(f, x) || !rawLit(x)) return false;
+        if (value(toLit(x)) == l_Undef)
+            uncheckedEnqueue(toLit(x));
+        else if (value(toLit(x)) == l_False)
+            ok = false; }
+
+    // Problem clauses:
+    vec<Lit> lits;
+    if (!readRaw(f, n)) return false;
+    for (int i = 0; i < n; i++){
+        if (!readRaw(f, m) || !readRaw(f, act) || !readRaw(f, lbd)) return false;
+        lits.clear();
+        for (int j = 0; j < m; j++){
+            if (!readRaw(f, x) || !rawLit(x)) return false;
+            lits.push(toLit(x)); }
+        if (ok) addClause_(lits);
+    }
+
+    // Learnt clauses (the top-level assignments are removed from them like from problem clauses):
+    if (!readRaw(f, n)) return false;
+    for (int i = 0; i < n; i++){
+        if (!readRaw(f, m) || !readRaw(f, act) || !readRaw(f, lbd)) return false;
+        lits.clear();
+        bool sat = false;
+        for (int j = 0; j < m; j++){
+            if (!readRaw(f, x) || !rawLit(x)) return false;
+            if (value(toLit(x)) == l_True)
+                sat = true;
+            else if (value(toLit(x)) == l_Undef)
+                lits.push(toLit(x)); }
+        if (!ok || sat)
+            continue;
+        else if (lits.size() == 0)
+            ok = false;
+        else if (lits.size() == 1)
+            uncheckedEnqueue(lits[0]);
+        else{
+            CRef cr = ca.alloc(lits, true);
+            ca[cr].activity() = act;
+            ca[cr].lbd(lbd);
+            learnts.push(cr);
+            attachClause(cr); }
+    }
+
+    // Xor-clauses (as literals whose exclusive-or must be true):
+    if (!readRaw(f, n)) return false;
+    for (int i = 0; i < n; i++){
+        char rhs;
+        if (!readRaw(f, rhs) || !readRaw(f, m)) return false;
+        lits.clear();
+        for (int j = 0; j < m; j++){
+            if (!readRaw(f, x) || x < 0 || x >= nVars()) return false;
+            lits.push(mkLit(x, j == 0 && !rhs)); }
+        if (ok) addXorClause(lits);
+    }
+
+    // Cardinality constraints:
+    if (!readRaw(f, n)) return false;
+    for (int i = 0; i < n; i++){
+        int32_t guard, bound;
+        if (!readRaw(f, guard) || !readRaw(f, bound) || !readRaw(f, m)) return false;
+        if (guard != toInt(lit_Undef) && !rawLit(guard)) return false;
+        lits.clear();
+        for (int j = 0; j < m; j++){
+            if (!readRaw(f, x) || !rawLit(x)) return false;
+            lits.push(toLit(x)); }
+        if (ok) addAtLeast(lits, bound, toLit(guard));
+    }
+
+    if (!was_ok)
+        ok = false;
+    else if (ok)
+        ok = propagate() == CRef_Undef;
+
+    return true;
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -1010,12 +2554,25 @@ void Solver::relocAll(ClauseAllocator& to)
     // All watchers:
     //
     watches.cleanAll();
+    watches_bin.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
             vec<Watcher>& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+#ifdef MINISAT_INLINE_WATCHERS
+            // Compact the lists that use less than half of their capacity, leaving room to grow:
+            if (ws.capacity() > 2 * ws.size() + 8){
+                vec<Watcher> tmp;
+                tmp.capacity(ws.size() + ws.size() / 2 + 4);
+                for (int j = 0; j < ws.size(); j++)
+                    tmp.push_(ws[j]);
+                tmp.moveTo(ws); }
+#endif
+            vec<Watcher>& wbin = watches_bin[p];
+            for (int j = 0; j < wbin.size(); j++)
+                ca.reloc(wbin[j].cref, to);
         }
 
     // All reasons:
@@ -1025,12 +2582,17 @@ void Solver::relocAll(ClauseAllocator& to)
 
         // Note: it is not safe to call 'locked()' on a relocated clause. This is why we keep
         // 'dangling' reasons here. It is safe and does not hurt.
-        if (reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)]))){
+        if (reason(v) != CRef_Undef && reason(v) != CRef_Lazy && (ca[reason(v)].reloced() || locked(ca[reason(v)]))){
             assert(!isRemoved(reason(v)));
             ca.reloc(vardata[v].reason, to);
         }
     }
 
+    // All temporary xor-conflict clauses:
+    //
+    for (int i = 0; i < tmp_confls.size(); i++)
+        ca.reloc(tmp_confls[i], to);
+
     // All learnt:
     //
     int i, j;
@@ -1060,7 +2622,7 @@ void Solver::garbageCollect()
 
     relocAll(to);
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
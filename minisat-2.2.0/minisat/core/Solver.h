@@ -21,12 +21,18 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <atomic>
+#include <vector>
+
 #include "minisat/mtl/Vec.h"
 #include "minisat/mtl/Heap.h"
+#include "minisat/mtl/ScoreHeap.h"
 #include "minisat/mtl/Alg.h"
 #include "minisat/mtl/IntMap.h"
+#include "minisat/mtl/Map.h"
 #include "minisat/utils/Options.h"
 #include "minisat/core/SolverTypes.h"
+#include "minisat/core/DratWriter.h"
 
 
 namespace Minisat {
@@ -55,6 +61,9 @@ public:
     bool    addClause (Lit p, Lit q, Lit r, Lit s);             // Add a quaternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+    bool    addXorClause(const vec<Lit>& ps);                   // Add an xor-clause (the exclusive-or of the literals must be true) to the solver.
+    bool    addAtLeast(const vec<Lit>& ps, int k, Lit guard = lit_Undef); // Add the constraint 'guard -> at least k of ps are true' (no guard
+                                                                // if 'guard' is 'lit_Undef').
 
     // Solving:
     //
@@ -74,6 +83,8 @@ public:
     ClauseIterator clausesEnd()   const;
     TrailIterator  trailBegin()   const;
     TrailIterator  trailEnd  ()   const;
+    void    exportLearnts(vec<Lit>& out, int max_size) const; // Append the level 0 units and the learnt clauses of at most 'max_size' literals
+                                                                // to 'out', each terminated by 'lit_Undef'.
 
     void    toDimacs     (FILE* f, const vec<Lit>& assumps);            // Write CNF to file in DIMACS-format.
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
@@ -84,11 +95,26 @@ public:
     void    toDimacs     (const char* file, Lit p);
     void    toDimacs     (const char* file, Lit p, Lit q);
     void    toDimacs     (const char* file, Lit p, Lit q, Lit r);
+
+    // Checkpointing:
+    //
+    bool    writeCheckpoint(const char* file);  // Write the solver state and 'checkpoint_data' to a binary checkpoint file.
+    bool    readCheckpoint (const char* file);  // Restore the solver state and 'checkpoint_data' from a checkpoint file. Requires a fresh solver.
+
+    // Proof logging:
+    //
+    bool    openProof (const char* file);       // Write a binary DRAT proof to 'file'. Must be called before adding clauses;
+                                                // the proof refers to the clauses as given to 'addClause()'.
+    bool    closeProof();                       // Flush and close the proof, FALSE if writing it failed.
     
     // Variable mode:
     // 
     void    setPolarity    (Var v, lbool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
     void    setDecisionVar (Var v, bool b);  // Declare if a variable should be eligible for selection in the decision heuristic.
+    void    setActivity    (Var v, double a);// Set the activity of a variable, e.g. to give the decision heuristic an initial order.
+    void    setPhase       (Var v, bool b);  // Set the saved phase of a variable. Unlike 'setPolarity()', this is subject to phase saving.
+    void    setSimPhase    (Var v, bool b);  // Give a phase that rephasing may switch to, e.g. the value of a variable in a circuit simulation.
+    void    setProbe       (Var v, bool b);  // Declare if a variable is probed for failed literals in inprocessing (e.g. a circuit output).
 
     // Read state:
     //
@@ -137,11 +163,31 @@ public:
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
     int       min_learnts_lim;    // Minimum number to set the learnts limit to.
+    bool      gauss;              // Perform Gauss-Jordan elimination on the xor-clauses in 'simplify()'.
+    int       gauss_max_cells;    // Skip Gauss-Jordan elimination if the matrix would have more cells than this.
+    const char* checkpoint_file;  // If set, the search writes a checkpoint to this file at a restart ...
+    double    checkpoint_interval;// ... when at least this many CPU seconds have passed since the previous one (or the start of 'solve()').
+    vec<char> checkpoint_data;    // Opaque user data stored in (and restored from) a checkpoint.
 
     int       restart_first;      // The initial restart limit.                                                                (default 100)
     double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
     double    learntsize_factor;  // The intitial limit for learnt clauses is a factor of the original clauses.                (default 1 / 3)
     double    learntsize_inc;     // The limit for learnt clauses is multiplied with this factor each restart.                 (default 1.1)
+    bool      tiered_reduce;      // Reduce the learnt clauses in LBD tiers on a conflict schedule instead of by the size limit. (default false)
+    int       core_lbd;           // Learnt clauses with at most this LBD are kept forever.                                    (default 2)
+    int       tier2_lbd;          // Learnt clauses with at most this LBD are kept as long as they are used in conflicts.      (default 6)
+    int       first_reduce;       // The number of conflicts before the first reduction of the learnt clauses.                (default 2000)
+    int       inc_reduce;         // The increase of the number of conflicts between reductions.                              (default 300)
+    bool      stable_mode;        // Alternate between the focused mode and a stable mode with rare restarts and target phases,
+                                  // and rephase periodically.                                                                   (default false)
+    int       mode_first;         // The number of conflicts in the first focused mode; doubled after each stable mode.        (default 1000)
+    int       stable_restart_first;// The base restart interval in the stable mode.                                           (default 1024)
+    double    stable_var_decay;   // The variable activity decay factor in the stable mode.                                   (default 0.975)
+    int       rephase_first;      // The number of conflicts before the first rephasing; the intervals grow arithmetically.  (default 1000)
+    double    inprocess_frac;     // The propagations of an inprocessing round as a fraction of those since the previous one. (default 0)
+    int       chrono_backtrack;   // Backtrack only one level when a backjump would undo more levels than this (-1 = never). (default -1)
+    bool      reuse_trail;        // Keep the decision levels that a restart would make again in the same order.   (default false)
+    bool      vmtf;               // Decide by a variable move-to-front queue instead of the activity heap.         (default false)
 
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
@@ -150,6 +196,11 @@ public:
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, num_clauses, num_learnts, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t num_xors, xor_propagations, xor_conflicts, gauss_runs, gauss_units, gauss_equivs;
+    uint64_t num_cards, card_propagations, card_conflicts, card_reasons;
+    uint64_t stable_conflicts, stable_decisions, stable_propagations, mode_switches, rephases;
+    uint64_t inprocess_rounds, vivified_clauses, vivified_lits, otf_strengthened, probe_units;
+    uint64_t chrono_backtracks, missed_implications, reused_trails, reused_levels;
 
 protected:
 
@@ -158,10 +209,20 @@ protected:
     struct VarData { CRef reason; int level; };
     static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, l}; return d; }
 
+    // NOTE: with 'MINISAT_INLINE_WATCHERS' defined (experimental), a watcher also stores the size
+    // of its clause as it was when the watcher was made, and 'propagate()' prefetches the clauses of
+    // the watchers ahead. As the blocker is the other watched literal, the watcher then holds all
+    // that is needed to decide whether to touch the clause. The 'minisat_propbench' programs compare
+    // the two layouts.
     struct Watcher {
         CRef cref;
         Lit  blocker;
-        Watcher(CRef cr, Lit p) : cref(cr), blocker(p) {}
+#ifdef MINISAT_INLINE_WATCHERS
+        int  size;
+        Watcher(CRef cr, Lit p, int sz) : cref(cr), blocker(p), size(sz) {}
+#else
+        Watcher(CRef cr, Lit p, int)    : cref(cr), blocker(p) {}
+#endif
         bool operator==(const Watcher& w) const { return cref == w.cref; }
         bool operator!=(const Watcher& w) const { return cref != w.cref; }
     };
@@ -173,12 +234,23 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
-    struct VarOrderLt {
-        const IntMap<Var, double>&  activity;
-        bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
-        VarOrderLt(const IntMap<Var, double>&  act) : activity(act) { }
+    struct XorClause {
+        int      first;                   // The exclusive-or of the 'size' variables from 'xor_vars[first]' on ...
+        int      size;
+        bool     rhs;                     // ... must equal 'rhs'. The first two variables are watched.
+    };
+
+    struct CardConstraint {
+        int      first;                   // If 'guard' is true (or 'lit_Undef'), at least 'bound' of the 'size' literals
+        int      size;                    // from 'card_lits[first]' on must be true.
+        Lit      guard;
+        int      bound;
+        int      nof_false;               // The number of currently false literals of the constraint.
     };
 
+    struct VarPairHash {
+        uint32_t operator()(uint64_t k) const { return (uint32_t)(k ^ (k >> 32)); } };
+
     struct ShrinkStackElem {
         uint32_t i;
         Lit      l;
@@ -201,8 +273,40 @@ protected:
     VMap<VarData>       vardata;          // Stores reason and level for each variable.
     OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
-
-    Heap<Var,VarOrderLt>order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    // Binary clauses keep their clause in 'ca' (reasons, proofs, checkpoints and the
+    // simplifier's occurrence lists refer to it); only their watchers are separate:
+    OccLists<Lit, vec<Watcher>, WatcherDeleted, MkIndexLit>
+                        watches_bin;      // As 'watches' but for binary clauses, the blocker being the other literal.
+
+    ScoreHeap<Var>      order_heap;       // A priority queue of variables ordered with respect to the variable activity (copied in the heap).
+
+    VMap<Var>           vmtf_prev;        // The move-to-front queue: a doubly linked list of all variables ...
+    VMap<Var>           vmtf_next;
+    VMap<uint64_t>      vmtf_stamp;       // ... in the order of these stamps, given when a variable is moved to the front.
+    Var                 vmtf_first;
+    Var                 vmtf_last;        // (the front of the queue, decided first)
+    Var                 vmtf_search;      // The variables after this one in the queue are assigned.
+    uint64_t            vmtf_time;
+    bool                vmtf_sorted;      // The queue has been ordered by the activities before the first search.
+    vec<Var>            vmtf_bumped;      // The variables met by 'analyze()', moved to the front at its end.
+
+    vec<XorClause>      xors;             // List of xor-clauses.
+    vec<Var>            xor_vars;         // The variables of all xor-clauses, one clause after another.
+    std::vector<std::vector<int> >
+                        xor_watches;      // 'xor_watches[v]' is a list of (indices of) xor-clauses watching 'v' ('vec' would 'realloc()' the inner lists).
+    vec<CardConstraint> cards;            // List of cardinality constraints.
+    vec<Lit>            card_lits;        // The literals of all cardinality constraints, one constraint after another.
+    std::vector<std::vector<int> >
+                        card_occs;        // 'card_occs[toInt(p)]' is a list of (indices of) cardinality constraints containing 'p'.
+    std::vector<std::vector<int> >
+                        card_guards;      // 'card_guards[toInt(p)]' is a list of (indices of) cardinality constraints guarded by 'p'.
+    VMap<int>           card_reason;      // The cardinality constraint that implied a variable with the reason 'CRef_Lazy'.
+    VMap<int>           trail_pos;        // The position of an assigned variable in the trail (only maintained with cardinality constraints).
+
+    VMap<char>          tmp_reason;       // Tells if the reason of a variable is a temporary clause built by a non-clausal constraint.
+    vec<CRef>           tmp_confls;       // Temporary conflict clauses built by non-clausal constraints (freed in 'cancelUntil()').
+    Map<uint64_t,char,VarPairHash>
+                        gauss_derived;    // Equivalences already derived by Gauss-Jordan elimination.
 
     bool                ok;               // If FALSE, the constraints are already unsatisfiable. No part of the solver state may be used!
     double              cla_inc;          // Amount to bump next clause with.
@@ -225,8 +329,40 @@ protected:
     vec<ShrinkStackElem>analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<Lit>            cancel_tmp;
+    vec<Lit>            expl_tmp;
+
+    vec<uint64_t>       lbd_seen;         // 'lbd_seen[l]' is the 'lbd_stamp' of the last 'computeLBD()' that met decision level 'l'.
+    uint64_t            lbd_stamp;
+    vec<CRef>           reduce_tmp;
+
+    VMap<char>          init_pol;         // The initial polarity of each variable (as given by 'setPhase()').
+    VMap<lbool>         sim_pol;          // The phases given by 'setSimPhase()' (l_Undef if none).
+    VMap<char>          target_pol;       // The polarity in the longest conflict-free trail of the current stable mode.
+    VMap<char>          best_pol;         // The polarity in the longest conflict-free trail since the previous rephasing.
+    int                 target_assigned;  // The number of assignments in the target and best trails.
+    int                 best_assigned;
+    bool                stable;           // The solver is in the stable mode.
+    bool                has_sim_pol;
+    uint64_t            next_mode_switch; // The number of conflicts at which the mode is next switched.
+    uint64_t            mode_interval;    // The length of the next focused and stable mode in conflicts.
+    uint64_t            next_rephase;     // The number of conflicts at which the solver is next rephased.
+    int                 focused_restarts; // The positions of the current 'solve_()' call in the restart sequences ...
+    int                 stable_restarts;  // ... of the focused and the stable mode.
+
+    VMap<char>          probe;            // Tells if a variable is probed for failed literals.
+    vec<Var>            probe_vars;       // The variables declared with 'setProbe()' (possibly not probed any more).
+    int                 probe_next;       // The position in 'probe_vars' where the next probing continues.
+    int                 vivify_next;      // The position in 'learnts' where the next vivification continues.
+    uint64_t            inprocess_props;  // The number of propagations at the end of the previous inprocessing round.
+    bool                inprocess_pending;// Set by a reduction of the learnt clauses; an inprocessing round is run at the next restart.
+    vec<CRef>           otf_clauses;      // Learnt reasons that 'analyze()' found to be strengthenable ...
+    vec<Lit>            otf_lits;         // ... by removing these literals.
+    vec<Lit>            inprocess_tmp;
 
     double              max_learnts;
+    uint64_t            next_reduce;        // The number of conflicts at which 'reduceDB()' is next called ('tiered_reduce').
+    int                 reduce_interval;    // The number of conflicts between the previous and the next reduction.
     double              learntsize_adjust_confl;
     int                 learntsize_adjust_cnt;
 
@@ -234,7 +370,10 @@ protected:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    std::atomic<bool>   asynch_interrupt;   // Set from other threads by interrupt().
+
+    double              checkpoint_next;    // CPU time after which the next checkpoint is written.
+    DratWriter*         proof;              // The DRAT proof being written (NULL if none).
 
     // Main internal methods:
     //
@@ -242,17 +381,45 @@ protected:
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
+    void     uncheckedEnqueue (Lit p, int level, CRef from);                           // Enqueue a literal implied at a given (possibly lower) decision level.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
+    CRef     propagateXors    (Var v);                                                 // Propagate the xor-clauses watching the newly assigned 'v'.
+    CRef     xorExplain       (const XorClause& x, bool conflict);                     // Build a temporary reason (or conflict) clause for an xor-clause.
+    Var*     xorVars          (const XorClause& x) { return &xor_vars[x.first]; }      // The variables of an xor-clause (valid until the next 'addXor_()').
+    CRef     propagateCards   (Lit p);                                                 // Propagate the cardinality constraints affected by the newly assigned 'p'.
+    CRef     checkCard        (int i);                                                 // Propagate cardinality constraint 'i'. Returns possibly conflicting clause.
+    int      falseLevel       (const CardConstraint& c) const;                         // The highest level of the false literals of 'c'.
+    const Lit* cardLits       (const CardConstraint& c) const { return &card_lits[c.first]; } // The literals of a cardinality constraint.
+    CRef     reasonClause     (Var x);                                                 // The reason of 'x', building it first if it is 'CRef_Lazy'.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    int      orderConflict    (CRef confl, bool attached = true);                      // Watch the two highest-level literals of a conflict clause. Returns the conflict level.
+    int      reuseTrailLevel  ();                                                      // The decision level a restart can backtrack to.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, LSet& out_conflict);                             // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p);                                                 // (helper method for 'analyze()')
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+    template<class Lits>
+    unsigned computeLBD       (const Lits& ps, int size);                              // The number of distinct decision levels in 'ps'.
+    void     updateTargetPhases();                                                     // Save the conflict-free part of the trail as the target/best phases if it is longer.
+    void     rephase          ();                                                      // Reset the saved phases to the next ones of the rephasing cycle.
+    void     switchMode       ();                                                      // Switch between the focused and the stable mode.
+    bool     inprocess        ();                                                      // Run an inprocessing round at decision level 0. Returns FALSE if UNSAT.
+    bool     vivify           (uint64_t limit);                                        // Shorten core and tier-2 learnt clauses by propagating their negations.
+    bool     probeFailed      (uint64_t limit);                                        // Probe the variables in 'probe_vars' for failed literals.
+    bool     addUnit          (Lit p);                                                 // Add a derived unit at decision level 0 and propagate it.
+    void     strengthenOTF    ();                                                      // Strengthen the clauses found by 'analyze()' (after backtracking).
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
+    void     vmtfEnqueue      (Var v);                                                 // Link 'v' at the front of the move-to-front queue.
+    void     vmtfDequeue      (Var v);                                                 // Unlink 'v' from the move-to-front queue.
+    void     vmtfBump         ();                                                      // Move the variables in 'vmtf_bumped' to the front in their current order.
+    void     vmtfSort         ();                                                      // Order the move-to-front queue by the activities.
+    void     addXor_          (vec<Var>& vs, bool rhs);                                // Add and attach an xor-clause of at least two unassigned variables.
+    bool     simplifyXors     ();                                                      // Remove top-level assigned variables from the xor-clauses.
+    bool     gaussJordan      ();                                                      // Derive top-level units and equivalences from the xor-clauses.
 
     // Maintaining Variable/Clause activity:
     //
@@ -269,6 +436,7 @@ protected:
     void     removeClause     (CRef cr);               // Detach and free a clause.
     bool     isRemoved        (CRef cr) const;         // Test if a clause has been removed.
     bool     locked           (const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
+    Lit      impliedLit       (const Clause& c) const; // The literal a clause may be the reason of (binary clauses are not reordered in propagation).
     bool     satisfied        (const Clause& c) const; // Returns TRUE if a clause is satisfied in the current state.
 
     // Misc:
@@ -278,6 +446,16 @@ protected:
     CRef     reason           (Var x) const;
     int      level            (Var x) const;
     double   progressEstimate ()      const; // DELETE THIS ?? IT'S NOT VERY USEFUL ...
+
+    // Checkpointing (the file format is native-endian and meant for the same build):
+    //
+    virtual bool writeState   (FILE* f);                                               // Write the constraints, the heuristic, restart and inprocessing state and the search switches (at decision level 0).
+    virtual bool readState    (FILE* f);                                               // Read what 'writeState()' wrote into a fresh solver.
+    void     writeClauses     (FILE* f, const vec<CRef>& cs);
+    template<class T> static void writeRaw(FILE* f, const T& x){ fwrite(&x, sizeof(T), 1, f); }
+    template<class T> static bool readRaw (FILE* f, T& x)      { return fread(&x, sizeof(T), 1, f) == 1; }
+    long     rawLeft          (FILE* f) const;                                         // The number of bytes after the current position of 'f'.
+    bool     rawLit           (int32_t x) const { return x >= 0 && x < 2*nVars(); }   // Is 'x' the 'toInt()' of a literal of the solver?
     bool     withinBudget     ()      const;
     void     relocAll         (ClauseAllocator& to);
 
@@ -304,20 +482,38 @@ inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
 inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
+    if (vmtf){
+        if (decision[x] && (vmtf_search == var_Undef || vmtf_stamp[x] > vmtf_stamp[vmtf_search])) vmtf_search = x; }
+    else if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x, activity[x]); }
 
-inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
+inline void Solver::varDecayActivity() { var_inc *= (1 / (stable ? stable_var_decay : var_decay)); }
 inline void Solver::varBumpActivity(Var v) { varBumpActivity(v, var_inc); }
 inline void Solver::varBumpActivity(Var v, double inc) {
     if ( (activity[v] += inc) > 1e100 ) {
         // Rescale:
         for (int i = 0; i < nVars(); i++)
             activity[i] *= 1e-100;
+        order_heap.scale(1e-100);
         var_inc *= 1e-100; }
 
     // Update order_heap with respect to new activity:
     if (order_heap.inHeap(v))
-        order_heap.decrease(v); }
+        order_heap.increase(v, activity[v]); }
+
+template<class Lits>
+inline unsigned Solver::computeLBD(const Lits& ps, int size)
+{
+    lbd_seen.growTo(decisionLevel() + 1, 0);
+    lbd_stamp++;
+    unsigned n = 0;
+    for (int i = 0; i < size; i++){
+        int l = level(var(ps[i]));
+        if (lbd_seen[l] != lbd_stamp){
+            lbd_seen[l] = lbd_stamp;
+            n++; }
+    }
+    return n;
+}
 
 inline void Solver::claDecayActivity() { cla_inc *= (1 / clause_decay); }
 inline void Solver::claBumpActivity (Clause& c) {
@@ -342,7 +538,8 @@ inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
 
 inline bool     Solver::isRemoved       (CRef cr)         const { return ca[cr].mark() == 1; }
-inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
+inline bool     Solver::locked          (const Clause& c) const { Lit p = impliedLit(c); return value(p) == l_True && reason(var(p)) != CRef_Undef && reason(var(p)) != CRef_Lazy && ca.lea(reason(var(p))) == &c; }
+inline Lit      Solver::impliedLit      (const Clause& c) const { return c.size() == 2 && value(c[0]) != l_True ? c[1] : c[0]; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
@@ -358,6 +555,13 @@ inline int      Solver::nVars         ()      const   { return next_var; }
 // TODO: nFreeVars() is not quite correct, try to calculate right instead of adapting it like below:
 inline int      Solver::nFreeVars     ()      const   { return (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, lbool b){ user_pol[v] = b; }
+inline void     Solver::setActivity   (Var v, double a){
+    activity[v] = a;
+    if (order_heap.inHeap(v))
+        order_heap.update(v, a); }
+inline void     Solver::setPhase      (Var v, bool b) { polarity[v] = init_pol[v] = !b; }
+inline void     Solver::setSimPhase   (Var v, bool b) { sim_pol[v] = lbool(b); has_sim_pol = true; }
+inline void     Solver::setProbe      (Var v, bool b) { if (b && !probe[v]) probe_vars.push(v); probe[v] = b; }
 inline void     Solver::setDecisionVar(Var v, bool b) 
 { 
     if      ( b && !decision[v]) dec_vars++;
@@ -368,11 +572,11 @@ inline void     Solver::setDecisionVar(Var v, bool b)
 }
 inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts    + x; }
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
-inline void     Solver::interrupt(){ asynch_interrupt = true; }
-inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
+inline void     Solver::interrupt(){ asynch_interrupt.store(true, std::memory_order_relaxed); }
+inline void     Solver::clearInterrupt(){ asynch_interrupt.store(false, std::memory_order_relaxed); }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
-    return !asynch_interrupt &&
+    return !asynch_interrupt.load(std::memory_order_relaxed) &&
            (conflict_budget    < 0 || conflicts < (uint64_t)conflict_budget) &&
            (propagation_budget < 0 || propagations < (uint64_t)propagation_budget); }
 
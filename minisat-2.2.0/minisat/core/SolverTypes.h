@@ -23,6 +23,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_SolverTypes_h
 
 #include <assert.h>
+#include <string.h>
 
 #include "minisat/mtl/IntTypes.h"
 #include "minisat/mtl/Alg.h"
@@ -140,7 +141,11 @@ class Clause {
         unsigned has_extra : 1;
         unsigned reloced   : 1;
         unsigned size      : 27; }                        header;
-    union { Lit lit; float act; uint32_t abs; CRef rel; } data[0];
+    struct Info {
+        unsigned lbd       : 31;  // (number of decision levels in a learnt clause)
+        unsigned used      : 1; };// (learnt clause took part in a conflict since the last 'reduceDB()')
+    union { Lit lit; float act; uint32_t abs; Info info; } data[0];   // (a relocated clause stores its 'CRef' from 'data[0]' on)
+    // NOTE: a learnt clause always has the extra field (its activity), and its 'Info' after that.
 
     friend class ClauseAllocator;
 
@@ -151,14 +156,17 @@ class Clause {
         header.has_extra = use_extra;
         header.reloced   = 0;
         header.size      = ps.size();
+        assert(header.size == (unsigned)ps.size());
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
 
         if (header.has_extra){
-            if (header.learnt)
+            if (header.learnt){
                 data[header.size].act = 0;
-            else
+                data[header.size+1].info.lbd  = 0;
+                data[header.size+1].info.used = 0;
+            }else
                 calcAbstraction();
     }
     }
@@ -172,9 +180,10 @@ class Clause {
             data[i].lit = from[i];
 
         if (header.has_extra){
-            if (header.learnt)
+            if (header.learnt){
                 data[header.size].act = from.data[header.size].act;
-            else 
+                data[header.size+1]   = from.data[header.size+1];
+            }else 
                 data[header.size].abs = from.data[header.size].abs;
     }
     }
@@ -189,17 +198,24 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size());
+                                               if (header.has_extra) data[header.size-i] = data[header.size];
+                                               if (header.learnt) data[header.size-i+1] = data[header.size+1];
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
+    unsigned     lbd         ()      const   { assert(header.learnt); return data[header.size+1].info.lbd; }
+    void         lbd         (unsigned l)    { assert(header.learnt); data[header.size+1].info.lbd = l; }
+    bool         used        ()      const   { assert(header.learnt); return data[header.size+1].info.used; }
+    void         used        (bool u)        { assert(header.learnt); data[header.size+1].info.used = u; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
     bool         reloced     ()      const   { return header.reloced; }
-    CRef         relocation  ()      const   { return data[0].rel; }
-    void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
+    CRef         relocation  ()      const   { CRef c; memcpy(&c, data, sizeof(CRef)); return c; }
+    void         relocate    (CRef c)        { header.reloced = 1; memcpy(data, &c, sizeof(CRef)); }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -219,19 +235,22 @@ public:
 // ClauseAllocator -- a simple class for allocating memory for clauses:
 
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
+const CRef CRef_Lazy  = CRef_Undef - 1; // A reason that is built only when needed (see 'Solver::reasonClause()').
 class ClauseAllocator
 {
     RegionAllocator<uint32_t> ra;
 
-    static uint32_t clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static uint32_t clauseWord32Size(int size, bool has_extra, bool learnt){
+        int words = size + (int)has_extra + (int)learnt;
+        if (words < (int)(sizeof(CRef) / sizeof(uint32_t))) words = sizeof(CRef) / sizeof(uint32_t);   // (room for 'relocate()')
+        return (sizeof(Clause) + (sizeof(Lit) * words)) / sizeof(uint32_t); }
 
  public:
     enum { Unit_Size = RegionAllocator<uint32_t>::Unit_Size };
 
     bool extra_clause_field;
 
-    ClauseAllocator(uint32_t start_cap) : ra(start_cap), extra_clause_field(false){}
+    ClauseAllocator(CRef start_cap) : ra(start_cap), extra_clause_field(false){}
     ClauseAllocator() : extra_clause_field(false){}
 
     void moveTo(ClauseAllocator& to){
@@ -243,7 +262,7 @@ class ClauseAllocator
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra));
+        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra, learnt));
         new (lea(cid)) Clause(ps, use_extra, learnt);
 
         return cid;
@@ -252,12 +271,12 @@ class ClauseAllocator
     CRef alloc(const Clause& from)
     {
         bool use_extra = from.learnt() | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra));
+        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra, from.learnt()));
         new (lea(cid)) Clause(from, use_extra);
         return cid; }
 
-    uint32_t size      () const      { return ra.size(); }
-    uint32_t wasted    () const      { return ra.wasted(); }
+    CRef     size      () const      { return ra.size(); }
+    CRef     wasted    () const      { return ra.wasted(); }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     Clause&       operator[](CRef r)         { return (Clause&)ra[r]; }
@@ -269,7 +288,7 @@ class ClauseAllocator
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        ra.free(clauseWord32Size(c.size(), c.has_extra()));
+        ra.free(clauseWord32Size(c.size(), c.has_extra(), c.learnt()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -384,7 +403,7 @@ template<class T>
 class CMap
 {
     struct CRefHash {
-        uint32_t operator()(CRef cr) const { return (uint32_t)cr; } };
+        uint32_t operator()(CRef cr) const { return (uint32_t)((uint64_t)cr ^ ((uint64_t)cr >> 32)); } };
 
     typedef Map<CRef, T, CRefHash> HashTable;
     HashTable map;
@@ -29,32 +29,39 @@ namespace Minisat {
 //=================================================================================================
 // Simple Region-based memory allocator:
 
+// NOTE: With 'MINISAT_CREF64' defined, references are 64 bits wide and the region is not limited
+// to 2^32 units. With 'MINISAT_MMAP' defined, the region is an anonymous mapping grown with
+// 'mremap()', so that growing a huge region does not copy it.
+//
 template<class T>
 class RegionAllocator
 {
-    T*        memory;
-    uint32_t  sz;
-    uint32_t  cap;
-    uint32_t  wasted_;
-
-    void capacity(uint32_t min_cap);
-
  public:
     // TODO: make this a class for better type-checking?
+#ifdef MINISAT_CREF64
+    typedef uint64_t Ref;
+#else
     typedef uint32_t Ref;
-    enum { Ref_Undef = UINT32_MAX };
+#endif
+    enum : Ref { Ref_Undef = ~(Ref)0 };
     enum { Unit_Size = sizeof(T) };
 
-    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
-    ~RegionAllocator()
-    {
-        if (memory != NULL)
-            ::free(memory);
-    }
+ private:
+    T*        memory;
+    Ref       sz;
+    Ref       cap;
+    Ref       wasted_;
+
+    void capacity(Ref min_cap);
+    void release ();
+
+ public:
+    explicit RegionAllocator(Ref start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
+    ~RegionAllocator() { release(); }
 
 
-    uint32_t size      () const      { return sz; }
-    uint32_t wasted    () const      { return wasted_; }
+    Ref      size      () const      { return sz; }
+    Ref      wasted    () const      { return wasted_; }
 
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
@@ -69,7 +76,7 @@ class RegionAllocator
         return  (Ref)(t - &memory[0]); }
 
     void     moveTo(RegionAllocator& to) {
-        if (to.memory != NULL) ::free(to.memory);
+        to.release();
         to.memory = memory;
         to.sz = sz;
         to.cap = cap;
@@ -83,17 +90,30 @@ class RegionAllocator
 };
 
 template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap)
+void RegionAllocator<T>::release()
+{
+    if (memory == NULL) return;
+#ifdef MINISAT_MMAP
+    xmunmap(memory, sizeof(T)*cap);
+#else
+    ::free(memory);
+#endif
+    memory = NULL;
+}
+
+
+template<class T>
+void RegionAllocator<T>::capacity(Ref min_cap)
 {
     if (cap >= min_cap) return;
 
-    uint32_t prev_cap = cap;
+    Ref prev_cap = cap;
     while (cap < min_cap){
         // NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
         // result even by clearing the least significant bit. The resulting sequence of capacities
         // is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
         // using 'uint32_t' as indices so that as much as possible of this space can be used.
-        uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+        Ref delta = ((cap >> 1) + (cap >> 3) + 2) & ~(Ref)1;
         cap += delta;
 
         if (cap <= prev_cap)
@@ -102,7 +122,11 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
     // printf(" .. (%p) cap = %u\n", this, cap);
 
     assert(cap > 0);
+#ifdef MINISAT_MMAP
+    memory = (T*)xmremap(memory, sizeof(T)*prev_cap, sizeof(T)*cap);
+#else
     memory = (T*)xrealloc(memory, sizeof(T)*cap);
+#endif
 }
 
 
@@ -114,7 +138,7 @@ RegionAllocator<T>::alloc(int size)
     assert(size > 0);
     capacity(sz + size);
 
-    uint32_t prev_sz = sz;
+    Ref prev_sz = sz;
     sz += size;
     
     // Handle overflow:
@@ -0,0 +1,182 @@
+/*************************************************************************************[ScoreHeap.h]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_ScoreHeap_h
+#define Minisat_ScoreHeap_h
+
+#include "minisat/mtl/Vec.h"
+#include "minisat/mtl/IntMap.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// A D-ary maximum-heap of keys by a score that is stored next to the key in the heap array. The
+// comparisons then read no other memory, and the D children of a node are adjacent (with D = 4
+// and double scores they span a single cache line or two). The owner must report each change of
+// a score with 'increase()' or 'update()'.
+
+
+template<class K, class S = double, int D = 4, class MkIndex = MkIndexDefault<K> >
+class ScoreHeap {
+    struct Elem { S score; K key; };
+
+    vec<Elem>             heap;     // Heap of keys and their scores
+    IntMap<K,int,MkIndex> indices;  // Each Key's position (index) in the Heap
+
+    // Index "traversal" functions
+    static inline int child (int i) { return i*D+1; }    // (the first one)
+    static inline int parent(int i) { return (i-1) / D; }
+
+
+    void percolateUp(int i)
+    {
+        Elem x = heap[i];
+        int  p = parent(i);
+
+        while (i != 0 && x.score > heap[p].score){
+            heap[i]              = heap[p];
+            indices[heap[p].key] = i;
+            i                    = p;
+            p                    = parent(p);
+        }
+        heap   [i]     = x;
+        indices[x.key] = i;
+    }
+
+
+    void percolateDown(int i)
+    {
+        Elem x = heap[i];
+        while (child(i) < heap.size()){
+            int c   = child(i);
+            int end = c + D < heap.size() ? c + D : heap.size();
+            for (int j = c + 1; j < end; j++)
+                if (heap[j].score > heap[c].score)
+                    c = j;
+            if (!(heap[c].score > x.score)) break;
+            heap[i]              = heap[c];
+            indices[heap[i].key] = i;
+            i                    = c;
+        }
+        heap   [i]     = x;
+        indices[x.key] = i;
+    }
+
+
+  public:
+    ScoreHeap(MkIndex _index = MkIndex()) : indices(_index) {}
+
+    int  size      ()          const { return heap.size(); }
+    bool empty     ()          const { return heap.size() == 0; }
+    bool inHeap    (K k)       const { return indices.has(k) && indices[k] >= 0; }
+    K    operator[](int index) const { assert(index < heap.size()); return heap[index].key; }
+
+    // The score of 'k' has grown to 's':
+    void increase  (K k, S s) { assert(inHeap(k)); heap[indices[k]].score = s; percolateUp(indices[k]); }
+
+
+    // Safe variant of insert/increase:
+    void update(K k, S s)
+    {
+        if (!inHeap(k))
+            insert(k, s);
+        else {
+            heap[indices[k]].score = s;
+            percolateUp(indices[k]);
+            percolateDown(indices[k]); }
+    }
+
+
+    void insert(K k, S s)
+    {
+        indices.reserve(k, -1);
+        assert(!inHeap(k));
+
+        Elem e = { s, k };
+        indices[k] = heap.size();
+        heap.push(e);
+        percolateUp(indices[k]);
+    }
+
+
+    void remove(K k)
+    {
+        assert(inHeap(k));
+
+        int k_pos  = indices[k];
+        indices[k] = -1;
+
+        if (k_pos < heap.size()-1){
+            K moved                  = heap.last().key;
+            heap[k_pos]              = heap.last();
+            indices[moved]           = k_pos;
+            heap.pop();
+            percolateUp(k_pos);
+            if (indices[moved] == k_pos)
+                percolateDown(k_pos);
+        }else
+            heap.pop();
+    }
+
+
+    K removeMax()
+    {
+        K x                  = heap[0].key;
+        heap[0]              = heap.last();
+        indices[heap[0].key] = 0;
+        indices[x]           = -1;
+        heap.pop();
+        if (heap.size() > 1) percolateDown(0);
+        return x;
+    }
+
+
+    // Multiply all scores by 'f' (when the owner rescales its scores):
+    void scale(S f) { for (int i = 0; i < heap.size(); i++) heap[i].score *= f; }
+
+
+    // Rebuild the heap from scratch, using the elements in 'ns' and their scores in 'scores':
+    template<class Scores>
+    void build(const vec<K>& ns, const Scores& scores) {
+        for (int i = 0; i < heap.size(); i++)
+            indices[heap[i].key] = -1;
+        heap.clear();
+
+        for (int i = 0; i < ns.size(); i++){
+            assert(indices.has(ns[i]));
+            Elem e = { scores[ns[i]], ns[i] };
+            indices[ns[i]] = i;
+            heap.push(e); }
+
+        for (int i = heap.size() > 1 ? parent(heap.size() - 1) : -1; i >= 0; i--)
+            percolateDown(i);
+    }
+
+    void clear(bool dispose = false)
+    {
+        for (int i = 0; i < heap.size(); i++)
+            indices[heap[i].key] = -1;
+        heap.clear(dispose);
+    }
+};
+
+
+//=================================================================================================
+}
+
+#endif
@@ -23,6 +23,9 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <errno.h>
 #include <stdlib.h>
+#ifdef MINISAT_MMAP
+#include <sys/mman.h>
+#endif
 
 namespace Minisat {
 
@@ -39,6 +42,19 @@ static inline void* xrealloc(void *ptr, size_t size)
         return mem;
 }
 
+#ifdef MINISAT_MMAP
+// Anonymous mappings that grow in place or are moved by remapping pages, never by copying:
+static inline void* xmremap(void *ptr, size_t old_size, size_t size)
+{
+    void* mem = ptr == NULL ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                            : mremap(ptr, old_size, size, MREMAP_MAYMOVE);
+    if (mem == MAP_FAILED)
+        throw OutOfMemoryException();
+    return mem;
+}
+static inline void xmunmap(void *ptr, size_t size) { munmap(ptr, size); }
+#endif
+
 //=================================================================================================
 }
 
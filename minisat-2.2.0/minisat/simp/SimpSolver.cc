@@ -18,6 +18,10 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "minisat/mtl/Sort.h"
 #include "minisat/simp/SimpSolver.h"
 #include "minisat/utils/System.h"
@@ -33,9 +37,11 @@ static const char* _cat = "SIMP";
 static BoolOption   opt_use_asymm        (_cat, "asymm",        "Shrink clauses by asymmetric branching.", false);
 static BoolOption   opt_use_rcheck       (_cat, "rcheck",       "Check if a clause is already implied. (costly)", false);
 static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variable elimination.", true);
+static BoolOption   opt_use_gate_elim    (_cat, "gate-elim",    "Resolve only the gate definition clauses of a variable against its other clauses.", true);
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_subsumption_threads(_cat, "sub-threads", "The number of threads checking large subsumption queues.", 1, IntRange(1, 256));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -47,18 +53,22 @@ SimpSolver::SimpSolver() :
     grow               (opt_grow)
   , clause_lim         (opt_clause_lim)
   , subsumption_lim    (opt_subsumption_lim)
+  , subsumption_threads(opt_subsumption_threads)
   , simp_garbage_frac  (opt_simp_garbage_frac)
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , use_gate_elim      (opt_use_gate_elim)
   , extend_model       (true)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
+  , gate_eliminated_vars(0)
   , elimorder          (1)
   , use_simplification (true)
   , occurs             (ClauseDeleted(ca))
   , elim_heap          (ElimLt(n_occ))
+  , defs               (ClauseDeleted(ca))
   , bwdsub_assigns     (0)
   , n_touched          (0)
 {
@@ -86,6 +96,8 @@ Var SimpSolver::newVar(lbool upol, bool dvar) {
         occurs    .init  (v);
         touched   .insert(v, 0);
         elim_heap .insert(v);
+        defs      .init  (v);
+        n_defs    .insert(v, 0);
     }
     return v; }
 
@@ -125,6 +137,7 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
             } }
 
         result = lbool(eliminate(turn_off_simp));
+        if (result == l_False && proof != NULL) proof->addEmpty();
     }
 
     if (result == l_True)
@@ -185,6 +198,23 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
 }
 
 
+bool SimpSolver::addDefClause(const vec<Lit>& ps, Var def)
+{
+    int nclauses = clauses.size();
+
+    if (!addClause(ps))
+        return false;
+
+    // NOTE: a clause already satisfied at the top level is left out; the rest still define 'def'
+    // under the top-level assignment.
+    if (use_simplification && clauses.size() == nclauses + 1){
+        defs[def].push(clauses.last());
+        n_defs[def]++; }
+
+    return true;
+}
+
+
 void SimpSolver::removeClause(CRef cr)
 {
     const Clause& c = ca[cr];
@@ -210,10 +240,13 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
     // if (!find(subsumption_queue, &c))
     subsumption_queue.insert(cr);
 
+    if (proof != NULL) proof->add(c, l);
+
     if (c.size() == 2){
         removeClause(cr);
         c.strengthen(l);
     }else{
+        if (proof != NULL) proof->remove(c);
         detachClause(cr, true);
         c.strengthen(l);
         attachClause(cr);
@@ -337,6 +370,73 @@ bool SimpSolver::implied(const vec<Lit>& c)
 }
 
 
+// Subsumption queues at least this long are checked in parallel (with 'subsumption_threads' > 1):
+static const int parallel_subsumption_min = 10000;
+
+
+struct BestVarLt {
+    const vec<Var>& best;
+    BestVarLt(const vec<Var>& b) : best(b) {}
+    bool operator()(int x, int y) const { return best[x] < best[y] || (best[x] == best[y] && x < y); } };
+
+
+// Checks the clauses in the subsumption queue against the occurrence list of their least occurring
+// variable in 'subsumption_threads' threads, which only read the clauses and occurrence lists. The
+// queue is partitioned by that variable, so the clauses scanning the same list are checked by the
+// same thread. The candidates found are returned in 'hits' in queue order, as a sequential scan would
+// find them. Returns the number of queue entries covered:
+int SimpSolver::findSubsumedParallel(vec<SubsumeHit>& hits)
+{
+    occurs.cleanAll();
+
+    int      n = subsumption_queue.size();
+    vec<Var> best(n);
+    vec<int> order(n);
+    for (int i = 0; i < n; i++){
+        const Clause& c = ca[subsumption_queue[i]];
+        Var           b = var(c[0]);
+        for (int k = 1; k < c.size(); k++)
+            if (occurs[var(c[k])].size() < occurs[b].size())
+                b = var(c[k]);
+        best[i]  = b;
+        order[i] = i; }
+    sort(order, BestVarLt(best));
+
+    const int                              chunk = 256;
+    std::atomic<int>                       next(0);
+    std::vector<std::vector<SubsumeHit> >  found(subsumption_threads);   // (per thread; 'vec' would 'realloc()' the inner vectors)
+    std::vector<std::thread>               threads;
+    for (int t = 0; t < subsumption_threads; t++)
+        threads.push_back(std::thread([&, t]() {
+            for (int s = next.fetch_add(chunk); s < n; s = next.fetch_add(chunk))
+                for (int k = s; k < s + chunk && k < n; k++){
+                    int           i  = order[k];
+                    CRef          cr = subsumption_queue[i];
+                    const Clause& c  = ca[cr];
+                    if (c.mark()) continue;
+
+                    const vec<CRef>& cs = occurs[best[i]];
+                    for (int j = 0; j < cs.size(); j++){
+                        const Clause& d = ca[cs[j]];
+                        if (!d.mark() && cs[j] != cr && (subsumption_lim == -1 || d.size() < subsumption_lim)
+                            && c.subsumes(d) != lit_Error){
+                            SubsumeHit h = { i, j, cs[j] };
+                            found[t].push_back(h); }
+                    }
+                } }));
+    for (int t = 0; t < subsumption_threads; t++)
+        threads[t].join();
+
+    hits.clear();
+    for (int t = 0; t < (int)found.size(); t++)
+        for (int i = 0; i < (int)found[t].size(); i++)
+            hits.push(found[t][i]);
+    sort(hits, SubsumeHitLt());
+
+    return n;
+}
+
+
 // Backward subsumption + backward subsumption resolution
 bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 {
@@ -345,10 +445,17 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
     int deleted_literals = 0;
     assert(decisionLevel() == 0);
 
+    // Find the candidates of a large queue in parallel. They are checked again when applied below, in
+    // queue order, since earlier removals and strengthenings may have changed them:
+    vec<SubsumeHit> hits;
+    int             batch = 0, popped = 0, next_hit = 0;
+    if (subsumption_threads > 1 && subsumption_queue.size() >= parallel_subsumption_min)
+        batch = findSubsumedParallel(hits);
+
     while (subsumption_queue.size() > 0 || bwdsub_assigns < trail.size()){
 
         // Empty subsumption queue and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        if (asynch_interrupt.load(std::memory_order_relaxed)){
             subsumption_queue.clear();
             bwdsub_assigns = trail.size();
             break; }
@@ -360,8 +467,9 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
             ca[bwdsub_tmpunit].calcAbstraction();
             subsumption_queue.insert(bwdsub_tmpunit); }
 
-        CRef    cr = subsumption_queue.peek(); subsumption_queue.pop();
-        Clause& c  = ca[cr];
+        CRef    cr  = subsumption_queue.peek(); subsumption_queue.pop();
+        Clause& c   = ca[cr];
+        int     pos = popped++;
 
         if (c.mark()) continue;
 
@@ -370,6 +478,27 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 
         assert(c.size() > 1 || value(c[0]) == l_True);    // Unit-clauses should have been propagated before this point.
 
+        if (pos < batch){
+            // Apply the candidates found by 'findSubsumedParallel()':
+            while (next_hit < hits.size() && hits[next_hit].pos < pos)
+                next_hit++;
+            for (; next_hit < hits.size() && hits[next_hit].pos == pos && !c.mark(); next_hit++){
+                CRef d = hits[next_hit].cr;
+                if (ca[d].mark()) continue;
+                Lit l = c.subsumes(ca[d]);
+
+                if (l == lit_Undef)
+                    subsumed++, removeClause(d);
+                else if (l != lit_Error){
+                    deleted_literals++;
+
+                    if (!strengthenClause(d, ~l))
+                        return false;
+                }
+            }
+            continue;
+        }
+
         // Find best variable to scan:
         Var best = var(c[0]);
         for (int i = 1; i < c.size(); i++)
@@ -482,6 +611,43 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
 
 
 
+// Moves the definition clauses of 'v' to the front of 'pos' and 'neg', and sets 'pos_def' and 'neg_def'
+// to their numbers. Returns FALSE if no definition of 'v' was given, or if one of its clauses has since
+// been removed or has lost 'v' by strengthening:
+bool SimpSolver::gateDefinition(Var v, vec<CRef>& pos, vec<CRef>& neg, int& pos_def, int& neg_def)
+{
+    vec<CRef>& ds = defs[v];
+    if (n_defs[v] == 0) return false;
+
+    int i, j;
+    for (i = j = 0; i < ds.size(); i++)
+        if (ca[ds[i]].mark() != 1)
+            ds[j++] = ds[i];
+    ds.shrink(i - j);
+    if (ds.size() != n_defs[v]){
+        ds.clear(true);
+        n_defs[v] = 0;
+        return false; }
+
+    sort(ds);
+    pos_def = neg_def = 0;
+    for (int k = 0; k < 2; k++){
+        vec<CRef>& cs = k == 0 ? pos : neg;
+        int&       n  = k == 0 ? pos_def : neg_def;
+        for (i = 0; i < cs.size(); i++){
+            int lo = 0, hi = ds.size();
+            while (lo < hi){
+                int mid = (lo + hi) / 2;
+                if (ds[mid] < cs[i]) lo = mid + 1; else hi = mid; }
+            if (lo < ds.size() && ds[lo] == cs[i]){
+                CRef tmp = cs[n]; cs[n++] = cs[i]; cs[i] = tmp; }
+        }
+    }
+
+    return pos_def + neg_def == ds.size() && pos_def > 0 && neg_def > 0;
+}
+
+
 bool SimpSolver::eliminateVar(Var v)
 {
     assert(!frozen[v]);
@@ -495,6 +661,14 @@ bool SimpSolver::eliminateVar(Var v)
     for (int i = 0; i < cls.size(); i++)
         (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
+    // If 'v' is defined by a gate, only the resolvents with a definition clause are needed; those
+    // among the other clauses are implied by them (Een & Biere, SatELite). Otherwise 'pos_def' and
+    // 'neg_def' cover all clauses and no pair is skipped:
+    //
+    int  pos_def, neg_def;
+    bool gate = use_gate_elim && gateDefinition(v, pos, neg, pos_def, neg_def);
+    if (!gate) pos_def = pos.size(), neg_def = neg.size();
+
     // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
     // clause must exceed the limit on the maximal clause size (if it is set):
     //
@@ -503,7 +677,7 @@ bool SimpSolver::eliminateVar(Var v)
 
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
+            if ((i < pos_def || j < neg_def) && merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
                 (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
                 return true;
 
@@ -511,6 +685,7 @@ bool SimpSolver::eliminateVar(Var v)
     eliminated[v] = true;
     setDecisionVar(v, false);
     eliminated_vars++;
+    if (gate) gate_eliminated_vars++;
 
     if (pos.size() > neg.size()){
         for (int i = 0; i < neg.size(); i++)
@@ -522,22 +697,32 @@ bool SimpSolver::eliminateVar(Var v)
         mkElimClause(elimclauses, ~mkLit(v));
     }
 
+    // Log the resolvents before their antecedents are deleted:
+    vec<Lit>& resolvent = add_tmp;
+    if (proof != NULL)
+        for (int i = 0; i < pos.size(); i++)
+            for (int j = 0; j < neg.size(); j++)
+                if ((i < pos_def || j < neg_def) && merge(ca[pos[i]], ca[neg[j]], v, resolvent))
+                    proof->add(resolvent);
+
     for (int i = 0; i < cls.size(); i++)
         removeClause(cls[i]); 
 
     // Produce clauses in cross product:
-    vec<Lit>& resolvent = add_tmp;
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
+            if ((i < pos_def || j < neg_def) && merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
                 return false;
 
-    // Free occurs list for this variable:
+    // Free occurs list and definition for this variable:
     occurs[v].clear(true);
+    defs  [v].clear(true);
     
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watches_bin[ mkLit(v)].size() == 0) watches_bin[ mkLit(v)].clear(true);
+    if (watches_bin[~mkLit(v)].size() == 0) watches_bin[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -565,6 +750,7 @@ bool SimpSolver::substitute(Var v, Lit x)
             subst_clause.push(var(p) == v ? x ^ sign(p) : p);
         }
 
+        if (proof != NULL) proof->add(subst_clause);
         removeClause(cls[i]);
 
         if (!addClause_(subst_clause))
@@ -610,7 +796,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
             ok = false; goto cleanup; }
 
         // Empty elim_heap and return immediately on user-interrupt:
-        if (asynch_interrupt){
+        if (asynch_interrupt.load(std::memory_order_relaxed)){
             assert(bwdsub_assigns == trail.size());
             assert(subsumption_queue.size() == 0);
             assert(n_touched == 0);
@@ -621,7 +807,7 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
             
-            if (asynch_interrupt) break;
+            if (asynch_interrupt.load(std::memory_order_relaxed)) break;
 
             if (isEliminated(elim) || value(elim) != l_Undef) continue;
 
@@ -654,6 +840,8 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         occurs   .clear(true);
         n_occ    .clear(true);
         elim_heap.clear(true);
+        defs     .clear(true);
+        n_defs   .clear(true);
         subsumption_queue.clear(true);
 
         use_simplification    = false;
@@ -677,6 +865,51 @@ bool SimpSolver::eliminate(bool turn_off_elim)
 }
 
 
+//=================================================================================================
+// Checkpointing:
+
+
+bool SimpSolver::writeState(FILE* f)
+{
+    if (!Solver::writeState(f))
+        return false;
+
+    for (Var v = 0; v < nVars(); v++)
+        writeRaw(f, eliminated[v]);
+    writeRaw(f, (int32_t)elimclauses.size());
+    for (int i = 0; i < elimclauses.size(); i++)
+        writeRaw(f, elimclauses[i]);
+
+    return true;
+}
+
+
+bool SimpSolver::readState(FILE* f)
+{
+    // The checkpointed clauses are already simplified, and the learnt clauses would prevent further
+    // elimination:
+    use_simplification = false;
+
+    if (!Solver::readState(f))
+        return false;
+    max_simp_var = nVars();
+
+    for (Var v = 0; v < nVars(); v++){
+        char elim;
+        if (!readRaw(f, elim)) return false;
+        frozen    .insert(v, (char)false);
+        eliminated.insert(v, elim); }
+
+    int32_t n;
+    if (!readRaw(f, n) || n < 0 || n > rawLeft(f) / (long)sizeof(uint32_t)) return false;
+    elimclauses.growTo(n);
+    for (int i = 0; i < n; i++)
+        if (!readRaw(f, elimclauses[i])) return false;
+
+    return true;
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -694,6 +927,18 @@ void SimpSolver::relocAll(ClauseAllocator& to)
             ca.reloc(cs[j], to);
     }
 
+    // Gate definitions (forgetting the removed clauses, see 'gateDefinition()'):
+    //
+    for (int i = 0; i < nVars(); i++){
+        vec<CRef>& ds = defs[i];
+        int j, k;
+        for (j = k = 0; j < ds.size(); j++)
+            if (ca[ds[j]].mark() != 1){
+                ca.reloc(ds[j], to);
+                ds[k++] = ds[j]; }
+        ds.shrink(j - k);
+    }
+
     // Subsumption queue:
     //
     for (int i = subsumption_queue.size(); i > 0; i--){
@@ -719,7 +964,7 @@ void SimpSolver::garbageCollect()
     relocAll(to);
     Solver::relocAll(to);
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64 " bytes => %12" PRIu64 " bytes             |\n",
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
 }
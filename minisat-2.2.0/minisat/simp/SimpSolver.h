@@ -48,6 +48,9 @@ class SimpSolver : public Solver {
     bool    addClause (Lit p, Lit q, Lit r); // Add a ternary clause to the solver.
     bool    addClause (Lit p, Lit q, Lit r, Lit s); // Add a quaternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);
+    bool    addXorClause(const vec<Lit>& ps);  // Add an xor-clause; its variables are frozen.
+    bool    addAtLeast(const vec<Lit>& ps, int k, Lit guard = lit_Undef); // Add a cardinality constraint; its variables are frozen.
+    bool    addDefClause(const vec<Lit>& ps, Var def); // Add a clause of the gate definition 'def <-> f(...)'.
     bool    substitute(Var v, Lit x);  // Replace all occurences of v with x (may cause a contradiction).
 
     // Variable mode:
@@ -91,11 +94,13 @@ class SimpSolver : public Solver {
     int     clause_lim;        // Variables are not eliminated if it produces a resolvent with a length above this limit.
                                // -1 means no limit.
     int     subsumption_lim;   // Do not check if subsumption against a clause larger than this. -1 means no limit.
+    int     subsumption_threads; // Check large subsumption queues in this many threads (1 means in the calling one).
     double  simp_garbage_frac; // A different limit for when to issue a GC during simplification (Also see 'garbage_frac').
 
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    bool    use_gate_elim;     // Resolve only the definition clauses of a gate variable against its other clauses.
     bool    extend_model;      // Flag to indicate whether the user needs to look at the full model.
 
     // Statistics:
@@ -103,6 +108,7 @@ class SimpSolver : public Solver {
     int     merges;
     int     asymm_lits;
     int     eliminated_vars;
+    int     gate_eliminated_vars;
 
  protected:
 
@@ -124,6 +130,16 @@ class SimpSolver : public Solver {
         //     return c_x < c_y || c_x == c_y && x < y; }
     };
 
+    struct SubsumeHit {
+        int  pos;   // Position of the subsuming (or strengthening) clause in the subsumption queue.
+        int  cand;  // Position of the candidate in the occurrence list that was scanned.
+        CRef cr;    // The candidate.
+    };
+
+    struct SubsumeHitLt {
+        bool operator()(const SubsumeHit& x, const SubsumeHit& y) const {
+            return x.pos < y.pos || (x.pos == y.pos && x.cand < y.cand); } };
+
     struct ClauseDeleted {
         const ClauseAllocator& ca;
         explicit ClauseDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
@@ -140,6 +156,9 @@ class SimpSolver : public Solver {
                         occurs;
     LMap<int>           n_occ;
     Heap<Var,ElimLt>    elim_heap;
+    OccLists<Var, vec<CRef>, ClauseDeleted>
+                        defs;                // The clauses of the gate definition of each variable, if given.
+    VMap<int>           n_defs;              // The number of definition clauses given (0 once one has been lost).
     Queue<CRef>         subsumption_queue;
     VMap<char>          frozen;
     vec<Var>            frozen_vars;
@@ -160,7 +179,9 @@ class SimpSolver : public Solver {
     void          gatherTouchedClauses     ();
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
+    int           findSubsumedParallel     (vec<SubsumeHit>& hits);
     bool          backwardSubsumptionCheck (bool verbose = false);
+    bool          gateDefinition           (Var v, vec<CRef>& pos, vec<CRef>& neg, int& pos_def, int& neg_def);
     bool          eliminateVar             (Var v);
     void          extendModel              ();
 
@@ -168,6 +189,9 @@ class SimpSolver : public Solver {
     bool          strengthenClause         (CRef cr, Lit l);
     bool          implied                  (const vec<Lit>& c);
     void          relocAll                 (ClauseAllocator& to);
+
+    bool          writeState               (FILE* f); // Also writes the eliminated variables and their clauses.
+    bool          readState                (FILE* f); // A restored solver does not eliminate variables anymore.
 };
 
 
@@ -189,6 +213,11 @@ inline bool SimpSolver::addClause    (Lit p)                 { add_tmp.clear();
 inline bool SimpSolver::addClause    (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
+inline bool SimpSolver::addXorClause (const vec<Lit>& ps)    { for (int i = 0; i < ps.size(); i++) setFrozen(var(ps[i]), true); return Solver::addXorClause(ps); }
+inline bool SimpSolver::addAtLeast   (const vec<Lit>& ps, int k, Lit guard){
+    for (int i = 0; i < ps.size(); i++) setFrozen(var(ps[i]), true);
+    if (guard != lit_Undef) setFrozen(var(guard), true);
+    return Solver::addAtLeast(ps, k, guard); }
 inline void SimpSolver::setFrozen    (Var v, bool b) { frozen[v] = (char)b; if (use_simplification && !b) { updateElimHeap(v); } }
 
 inline void SimpSolver::freezeVar(Var v){
@@ -0,0 +1,60 @@
+#!/bin/sh
+# A/B comparison of the watcher layouts of propagate() (see MINISAT_PROPBENCH in CMakeLists.txt).
+#
+# Usage: propbench.sh <build dir> [propbench options] <file>...
+#
+# Each file is a DIMACS CNF (plain or gzipped) or a circuit (.bc), which is first converted with
+# bc2cnf ($BC2CNF, default 'bc2cnf'). Both binaries must report the same propagation counts, or the
+# comparison is void.
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 <build dir> [propbench options] <file>..." >&2
+    exit 1
+fi
+dir=$1; shift
+opts=
+while [ $# -gt 0 ]; do
+    case $1 in
+        -*) opts="$opts $1"; shift ;;
+        *)  break ;;
+    esac
+done
+
+for bin in "$dir/minisat_propbench_a" "$dir/minisat_propbench_b"; do
+    if [ ! -x "$bin" ]; then
+        echo "$bin not found (configure with -DMINISAT_PROPBENCH=ON)" >&2
+        exit 1
+    fi
+done
+
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+
+status=0
+for f in "$@"; do
+    case $f in
+        *.bc) cnf="$tmp/in.cnf"
+              if ! ${BC2CNF:-bc2cnf} "$f" "$cnf" >/dev/null; then
+                  echo "$f: bc2cnf failed" >&2; status=1; continue
+              fi ;;
+        *)    cnf=$f ;;
+    esac
+    "$dir/minisat_propbench_a" $opts "$cnf" > "$tmp/a" || { status=1; continue; }
+    "$dir/minisat_propbench_b" $opts "$cnf" > "$tmp/b" || { status=1; continue; }
+
+    # Fields 2 and 6 of the 'rounds:' and 'search:' lines are the propagations and the seconds:
+    read pra ta1 psa ta2 <<END
+$(grep -h '^rounds:\|^search:' "$tmp/a" | awk '{print $2, $6}' | tr '\n' ' ')
+END
+    read prb tb1 psb tb2 <<END
+$(grep -h '^rounds:\|^search:' "$tmp/b" | awk '{print $2, $6}' | tr '\n' ' ')
+END
+    if [ "$pra" != "$prb" ] || [ "$psa" != "$psb" ]; then
+        echo "$f: WARNING: the propagation counts differ" >&2
+        status=1
+    fi
+    awk -v f="$f" -v a1="$ta1" -v b1="$tb1" -v a2="$ta2" -v b2="$tb2" 'BEGIN {
+        printf "%-40s rounds %8.3f s -> %8.3f s (%5.2fx)   search %8.3f s -> %8.3f s (%5.2fx)\n", f,
+               a1, b1, (b1 > 0 ? a1 / b1 : 0), a2, b2, (b2 > 0 ? a2 / b2 : 0) }'
+done
+exit $status
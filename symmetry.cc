@@ -0,0 +1,435 @@
+/*
+ Copyright (C) Tommi Junttila
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License version 2
+ as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cassert>
+#include <algorithm>
+#include <list>
+#include <vector>
+#include "defs.hh"
+#include "bc.hh"
+
+/**************************************************************************
+ *
+ * Symmetry detection and breaking
+ *
+ * The circuit is viewed as a vertex-colored graph whose vertices are the
+ * gates and whose edges go from gates to their children.
+ * The initial color of a gate is given by its type, value and threshold
+ * bounds, and the edges to the children of ITE gates are labelled by
+ * the child position.
+ * Automorphisms of this graph are searched with the classic
+ * individualization-refinement scheme: the coloring is refined into an
+ * equitable one, a vertex in a non-singleton cell is individualized in
+ * the "left" coloring and each candidate image in the "right" one, and
+ * the search proceeds until both colorings are discrete and define
+ * a permutation that is then checked to be an automorphism.
+ * Only the first path of the search tree is followed, giving generators
+ * for a chain of point stabilizers.
+ *
+ **************************************************************************/
+
+/* Lex-leader constraints are built over at most this many inputs */
+static const unsigned int symmetry_lex_length = 32;
+
+/* A budget, in visited edges, for the refinements in the search */
+static const unsigned long symmetry_work_budget = 50000000;
+
+typedef std::vector<std::pair<unsigned int, unsigned int> > SymmetryEdges;
+
+namespace {
+
+class SymmetryGraph {
+public:
+  std::vector<Gate*> gates;
+  /* (label, vertex) pairs; the label is 0 for the children of
+   * commutative gates and the child position + 1 for ITE gates */
+  std::vector<SymmetryEdges> children;
+  std::vector<SymmetryEdges> parents;
+  std::vector<unsigned int> initial_color;
+  unsigned long work;
+
+  unsigned int size() const {return gates.size(); }
+  bool out_of_budget() const {return work > symmetry_work_budget; }
+};
+
+}
+
+
+static uint64_t
+symmetry_mix(uint64_t h, const uint64_t x)
+{
+  h ^= x + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+  return h ^ (h >> 31);
+}
+
+
+/*
+ * Renumber the colors into 0,1,... in the order of the keys.
+ * Returns the number of colors, the trace is updated with the keys
+ * and their multiplicities.
+ */
+static unsigned int
+symmetry_rank(const std::vector<std::pair<uint64_t, uint64_t> >& keys,
+	      std::vector<unsigned int>& color,
+	      uint64_t& trace)
+{
+  std::vector<std::pair<uint64_t, uint64_t> > sorted(keys);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::pair<uint64_t, uint64_t> > distinct;
+  for(unsigned int i = 0; i < sorted.size(); )
+    {
+      unsigned int j = i;
+      while(j < sorted.size() and sorted[j] == sorted[i])
+	j++;
+      trace = symmetry_mix(trace, sorted[i].first);
+      trace = symmetry_mix(trace, sorted[i].second);
+      trace = symmetry_mix(trace, j - i);
+      distinct.push_back(sorted[i]);
+      i = j;
+    }
+  for(unsigned int v = 0; v < keys.size(); v++)
+    color[v] = std::lower_bound(distinct.begin(), distinct.end(), keys[v]) -
+      distinct.begin();
+  return distinct.size();
+}
+
+
+/*
+ * Refine the coloring until the colors of the neighbours no longer
+ * split any cell. Returns the number of cells, or 0 if out of budget.
+ */
+static unsigned int
+symmetry_refine(SymmetryGraph& g, std::vector<unsigned int>& color,
+		uint64_t& trace)
+{
+  const unsigned int n = g.size();
+  std::vector<std::pair<uint64_t, uint64_t> > keys(n);
+  std::vector<uint64_t> neighbours;
+  unsigned int nof_cells = 0;
+  for(unsigned int v = 0; v < n; v++)
+    nof_cells = std::max(nof_cells, color[v] + 1);
+  while(true)
+    {
+      for(unsigned int v = 0; v < n; v++)
+	{
+	  uint64_t h = 0;
+	  neighbours.clear();
+	  for(unsigned int i = 0; i < g.children[v].size(); i++)
+	    neighbours.push_back(((uint64_t)g.children[v][i].first << 32) |
+				 color[g.children[v][i].second]);
+	  std::sort(neighbours.begin(), neighbours.end());
+	  for(unsigned int i = 0; i < neighbours.size(); i++)
+	    h = symmetry_mix(h, neighbours[i]);
+	  h = symmetry_mix(h, ~(uint64_t)0);
+	  neighbours.clear();
+	  for(unsigned int i = 0; i < g.parents[v].size(); i++)
+	    neighbours.push_back(((uint64_t)g.parents[v][i].first << 32) |
+				 color[g.parents[v][i].second]);
+	  std::sort(neighbours.begin(), neighbours.end());
+	  for(unsigned int i = 0; i < neighbours.size(); i++)
+	    h = symmetry_mix(h, neighbours[i]);
+	  keys[v] = std::make_pair((uint64_t)color[v], h);
+	  g.work += g.children[v].size() + g.parents[v].size() + 1;
+	}
+      if(g.out_of_budget())
+	return 0;
+      const unsigned int new_nof_cells = symmetry_rank(keys, color, trace);
+      if(new_nof_cells == nof_cells)
+	return nof_cells;
+      nof_cells = new_nof_cells;
+    }
+}
+
+
+/*
+ * Put the vertex v in a cell of its own, just after its current cell
+ */
+static void
+symmetry_individualize(std::vector<unsigned int>& color, const unsigned int v)
+{
+  const unsigned int c = color[v];
+  for(unsigned int u = 0; u < color.size(); u++)
+    if(color[u] > c)
+      color[u]++;
+  color[v] = c + 1;
+}
+
+
+/*
+ * The first vertex in the smallest non-singleton cell,
+ * preferring the cells of input gates
+ */
+static int
+symmetry_target(const SymmetryGraph& g, const std::vector<unsigned int>& color)
+{
+  std::vector<unsigned int> cell_size(g.size(), 0);
+  for(unsigned int v = 0; v < g.size(); v++)
+    cell_size[color[v]]++;
+  int best = -1;
+  for(unsigned int v = 0; v < g.size(); v++)
+    {
+      if(cell_size[color[v]] <= 1)
+	continue;
+      if(best == -1)
+	{
+	  best = v;
+	  continue;
+	}
+      const bool v_input = g.gates[v]->type == Gate::tVAR;
+      const bool best_input = g.gates[best]->type == Gate::tVAR;
+      if(v_input != best_input)
+	{
+	  if(v_input)
+	    best = v;
+	  continue;
+	}
+      if(cell_size[color[v]] < cell_size[color[best]])
+	best = v;
+    }
+  return best;
+}
+
+
+static bool
+symmetry_is_automorphism(const SymmetryGraph& g,
+			 const std::vector<unsigned int>& perm)
+{
+  std::vector<std::pair<unsigned int, unsigned int> > mapped, image;
+  for(unsigned int v = 0; v < g.size(); v++)
+    {
+      const unsigned int w = perm[v];
+      if(g.initial_color[v] != g.initial_color[w])
+	return false;
+      if(g.children[v].size() != g.children[w].size())
+	return false;
+      mapped.clear();
+      for(unsigned int i = 0; i < g.children[v].size(); i++)
+	mapped.push_back(std::make_pair(g.children[v][i].first,
+					perm[g.children[v][i].second]));
+      image = g.children[w];
+      std::sort(mapped.begin(), mapped.end());
+      std::sort(image.begin(), image.end());
+      if(mapped != image)
+	return false;
+    }
+  return true;
+}
+
+
+/*
+ * Search for an automorphism mapping the left coloring to the right one
+ */
+static bool
+symmetry_search(SymmetryGraph& g,
+		std::vector<unsigned int> left,
+		std::vector<unsigned int> right,
+		std::vector<unsigned int>& perm)
+{
+  uint64_t left_trace = 0, right_trace = 0;
+  const unsigned int left_cells = symmetry_refine(g, left, left_trace);
+  if(left_cells == 0)
+    return false;
+  const unsigned int right_cells = symmetry_refine(g, right, right_trace);
+  if(right_cells != left_cells or right_trace != left_trace)
+    return false;
+
+  if(left_cells == g.size())
+    {
+      std::vector<unsigned int> vertex_of_color(g.size());
+      for(unsigned int v = 0; v < g.size(); v++)
+	vertex_of_color[right[v]] = v;
+      perm.resize(g.size());
+      for(unsigned int v = 0; v < g.size(); v++)
+	perm[v] = vertex_of_color[left[v]];
+      return symmetry_is_automorphism(g, perm);
+    }
+
+  const int x = symmetry_target(g, left);
+  assert(x >= 0);
+  for(unsigned int y = 0; y < g.size(); y++)
+    {
+      if(right[y] != left[x])
+	continue;
+      std::vector<unsigned int> new_left(left), new_right(right);
+      symmetry_individualize(new_left, x);
+      symmetry_individualize(new_right, y);
+      if(symmetry_search(g, new_left, new_right, perm))
+	return true;
+      if(g.out_of_budget())
+	return false;
+    }
+  return false;
+}
+
+
+static unsigned int
+symmetry_find(std::vector<unsigned int>& parent, unsigned int v)
+{
+  while(parent[v] != v)
+    {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+  return v;
+}
+
+
+/*
+ * Build the graph of the circuit and compute its initial coloring
+ */
+static void
+symmetry_build_graph(Gate* const first_gate, const unsigned int nof_indices,
+		     SymmetryGraph& g)
+{
+  std::vector<int> vertex(nof_indices, -1);
+  for(Gate* gate = first_gate; gate; gate = gate->next)
+    {
+      if(gate->type == Gate::tDELETED)
+	continue;
+      vertex[gate->index] = g.gates.size();
+      g.gates.push_back(gate);
+    }
+  const unsigned int n = g.size();
+  g.children.resize(n);
+  g.parents.resize(n);
+  std::vector<std::pair<std::pair<unsigned int, unsigned int>,
+			std::pair<unsigned int, unsigned int> > > props(n);
+  for(unsigned int v = 0; v < n; v++)
+    {
+      const Gate* const gate = g.gates[v];
+      const bool ordered = (gate->type == Gate::tITE);
+      unsigned int position = 1;
+      for(const ChildAssoc* ca = gate->children; ca; ca = ca->next_child)
+	{
+	  const unsigned int label = ordered ? position++ : 0;
+	  const int w = vertex[ca->child->index];
+	  assert(w >= 0);
+	  g.children[v].push_back(std::make_pair(label, (unsigned int)w));
+	  g.parents[w].push_back(std::make_pair(label, v));
+	}
+      const unsigned int value =
+	gate->determined ? (gate->value ? 2 : 1) : 0;
+      const bool bounds = (gate->type == Gate::tTHRESHOLD or
+			   gate->type == Gate::tATLEAST);
+      props[v] = std::make_pair(std::make_pair((unsigned int)gate->type, value),
+				std::make_pair(bounds ? gate->tmin : 0,
+					       bounds ? gate->tmax : 0));
+    }
+  std::vector<std::pair<std::pair<unsigned int, unsigned int>,
+			std::pair<unsigned int, unsigned int> > > distinct(props);
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()),
+		 distinct.end());
+  g.initial_color.resize(n);
+  for(unsigned int v = 0; v < n; v++)
+    g.initial_color[v] =
+      std::lower_bound(distinct.begin(), distinct.end(), props[v]) -
+      distinct.begin();
+  g.work = 0;
+}
+
+
+bool
+BC::add_symmetry_breaking(unsigned int& nof_generators,
+			  const unsigned int max_generators)
+{
+  nof_generators = 0;
+  if(preserve_all_solutions)
+    return true;
+
+  SymmetryGraph g;
+  symmetry_build_graph(first_gate, index_to_gate.size(), g);
+  const unsigned int n = g.size();
+
+  /*
+   * Find the generators
+   */
+  std::vector<std::vector<unsigned int> > generators;
+  std::vector<unsigned int> color(g.initial_color);
+  uint64_t trace = 0;
+  unsigned int nof_cells = symmetry_refine(g, color, trace);
+  while(nof_cells > 0 and nof_cells < n and
+	generators.size() < max_generators)
+    {
+      const int a = symmetry_target(g, color);
+      assert(a >= 0);
+      /* The orbits of the generators found at this level,
+       * they all fix the vertices individualized so far */
+      std::vector<unsigned int> orbit(n);
+      for(unsigned int v = 0; v < n; v++)
+	orbit[v] = v;
+      for(unsigned int b = 0; b < n; b++)
+	{
+	  if(b == (unsigned int)a or color[b] != color[a])
+	    continue;
+	  if(symmetry_find(orbit, b) == symmetry_find(orbit, a))
+	    continue;
+	  std::vector<unsigned int> left(color), right(color), perm;
+	  symmetry_individualize(left, a);
+	  symmetry_individualize(right, b);
+	  if(symmetry_search(g, left, right, perm))
+	    {
+	      for(unsigned int v = 0; v < n; v++)
+		orbit[symmetry_find(orbit, v)] = symmetry_find(orbit, perm[v]);
+	      generators.push_back(perm);
+	      if(generators.size() >= max_generators)
+		break;
+	    }
+	  if(g.out_of_budget())
+	    break;
+	}
+      if(g.out_of_budget())
+	break;
+      symmetry_individualize(color, a);
+      trace = 0;
+      nof_cells = symmetry_refine(g, color, trace);
+    }
+
+  /*
+   * Add the lex-leader constraints x <= perm(x) over the inputs,
+   * in the order of the gate list
+   */
+  for(unsigned int i = 0; i < generators.size(); i++)
+    {
+      const std::vector<unsigned int>& perm = generators[i];
+      Gate* prefix_equal = 0;
+      unsigned int length = 0;
+      for(unsigned int v = 0; v < n and length < symmetry_lex_length; v++)
+	{
+	  if(g.gates[v]->type != Gate::tVAR or perm[v] == v)
+	    continue;
+	  Gate* const x = g.gates[v];
+	  Gate* const y = g.gates[perm[v]];
+	  /* prefix_equal -> (x -> y) */
+	  std::list<Gate*> disjuncts;
+	  if(prefix_equal)
+	    disjuncts.push_back(new_NOT(prefix_equal));
+	  disjuncts.push_back(new_NOT(x));
+	  disjuncts.push_back(y);
+	  if(!force_true(new_OR(&disjuncts)))
+	    return false;
+	  Gate* const equal = new_EQUIV(x, y);
+	  prefix_equal = prefix_equal ? new_AND(prefix_equal, equal) : equal;
+	  length++;
+	}
+      if(length > 0)
+	nof_generators++;
+    }
+  return true;
+}
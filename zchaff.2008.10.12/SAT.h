@@ -131,6 +131,12 @@ enum CLAUSE_STATUS {
 //
 // 9. Release the manager by calling SAT_ReleaseManager.
 //
+// Managers share no state, so different managers may be used in
+// different threads at the same time (one thread per manager).
+// SAT_Interrupt is the only function that may be called on a manager
+// while another thread is using it. Time limits and run times are
+// measured in cpu time of the thread that calls SAT_Solve.
+//
 // You need to link the library libsat.a, also, though you can compile
 // your C program with c compiler when using this sat solver, you
 // still need c++ linker to link the library.
@@ -224,6 +230,10 @@ void SAT_SetTimeLimit(SAT_Manager       mng,
 void SAT_SetMemLimit(SAT_Manager        mng,
                      int                num_bytes);
 
+// the same in megabytes, for limits beyond 2 GB
+void SAT_SetMemLimitMB(SAT_Manager      mng,
+                       int              num_mbytes);
+
 
 int SAT_Solve(SAT_Manager mng);
 // enum SAT_StatusT
@@ -239,6 +249,19 @@ void SAT_SetRandomness(SAT_Manager      mng,
 void SAT_SetRandSeed(SAT_Manager        mng,
                      int                seed);
 
+// stop a SAT_Solve running in another thread; it returns ABORTED
+// soon after. The request stays pending, also for a SAT_Solve that
+// has not started yet, until SAT_ClearInterrupt is called.
+void SAT_Interrupt(SAT_Manager mng);
+
+void SAT_ClearInterrupt(SAT_Manager mng);
+
+// the file of the resolution trace (by default "resolve_trace"),
+// written only if the solver is compiled with VERIFY_ON. Managers
+// running at the same time should use different files.
+void SAT_SetTraceFile(SAT_Manager       mng,
+                      const char *      filename);
+
 // add a hookfunction. This function will be called
 // every "interval" of decisions. You can add more than
 // one such hook functions. i.e. call SAT_AddHookFun more
@@ -283,6 +306,9 @@ void SAT_MakeDecision(SAT_Manager        mng,
 
 // Following are statistics collecting functions
 int SAT_EstimateMemUsage(SAT_Manager mng);
+// the memory (in bytes) actually held by the clause database, the
+// variables and the assignment stack
+long64 SAT_MemUsage(SAT_Manager mng);
 // time elapsed from last call of GetElapsedCPUTime
 float SAT_GetElapsedCPUTime(SAT_Manager mng);
 // current cpu time
@@ -322,6 +348,16 @@ int SAT_Random_Seed(SAT_Manager mng);
 
 long64 SAT_NumImplications(SAT_Manager mng);
 
+// number of lit pool chunks allocated and chunk compactions done, and the
+// cpu time spent in them
+int SAT_NumLitPoolEnlarges(SAT_Manager mng);
+
+int SAT_NumLitPoolCompacts(SAT_Manager mng);
+
+float SAT_LitPoolEnlargeTime(SAT_Manager mng);
+
+float SAT_LitPoolCompactTime(SAT_Manager mng);
+
 int SAT_MaxDLevel(SAT_Manager mng);
 
 float SAT_AverageBubbleMove(SAT_Manager mng);
@@ -46,6 +46,10 @@
 
 #define VOLATILE_GID   -1
 #define        PERMANENT_GID         0
+// KEEP_LIT_CLAUSES keeps, for each literal, the list of all the clauses it
+// appears in. Nothing in the solver needs these lists (clause group deletion
+// scans the clauses), and they double the clause index memory, so they are
+// off unless ZCHAFF_KEEP_LIT_CLAUSES is set in CMakeLists.txt.
 // #define KEEP_LIT_CLAUSES
 typedef int ClauseIdx;  // Used to refer a clause. Because of dynamic
                         // allocation of vector storage, no pointer is allowered
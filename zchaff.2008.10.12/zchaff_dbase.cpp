@@ -34,10 +34,12 @@
 // ********************************************************************/
 
 #include <cstdlib>
+#include <cstddef>
 
 #include <iostream>
 #include <vector>
 #include <set>
+#include <algorithm>
 
 using namespace std;
 
@@ -54,42 +56,40 @@ CDatabase::CDatabase(void) {
   _stats.num_deleted_literals        = 0;
   _stats.num_enlarge                 = 0;
   _stats.num_compact                 = 0;
-  _lit_pool_start = (CLitPoolElement *) malloc(sizeof(CLitPoolElement) *
-                                               STARTUP_LIT_POOL_SIZE);
-  _lit_pool_finish = _lit_pool_start;
-  _lit_pool_end_storage = _lit_pool_start + STARTUP_LIT_POOL_SIZE;
-  lit_pool_push_back(0);  // set the first element as a dummy element
-  _params.mem_limit = 1024 * 1024 * 1024;  // that's 1 G
+  _stats.time_enlarge                = 0;
+  _stats.time_compact                = 0;
+  _lit_pool_cur = add_lit_pool_chunk(STARTUP_LIT_POOL_SIZE);
+  _params.mem_limit = 1024LL * 1024 * 1024;  // that's 1 G
   variables()->resize(1);                  // var_id == 0 is never used.
   _allocated_gid                    = 0;
 }
 
 CDatabase::~CDatabase(void) {
-  free(_lit_pool_start);
+  for (unsigned i = 0; i < _lit_pool.size(); ++i)
+    free(_lit_pool[i].start);
 }
 
-unsigned CDatabase::estimate_mem_usage(void) {
-  unsigned mem_lit_pool = sizeof(CLitPoolElement) * (lit_pool_size() +
-                                                     lit_pool_free_space());
-  unsigned mem_vars = sizeof(CVariable) * variables()->capacity();
-  unsigned mem_cls = sizeof(CClause) * clauses()->capacity();
-  unsigned mem_cls_queue = sizeof(int) * _unused_clause_idx.size();
-  unsigned mem_watched = 2 * num_clauses() * sizeof(CLitPoolElement *);
-  unsigned mem_lit_clauses = 0;
+long64 CDatabase::estimate_mem_usage(void) {
+  long64 mem_lit_pool = sizeof(CLitPoolElement) * lit_pool_capacity();
+  long64 mem_vars = sizeof(CVariable) * (long64)variables()->capacity();
+  long64 mem_cls = sizeof(CClause) * (long64)clauses()->capacity();
+  long64 mem_cls_queue = sizeof(int) * (long64)_unused_clause_idx.size();
+  long64 mem_watched = 2 * (long64)num_clauses() * sizeof(CLitPoolElement *);
+  long64 mem_lit_clauses = 0;
 #ifdef KEEP_LIT_CLAUSES
-  mem_lit_clauses = num_literals() * sizeof(ClauseIdx);
+  mem_lit_clauses = (long64)num_literals() * sizeof(ClauseIdx);
 #endif
   return (mem_lit_pool + mem_vars + mem_cls +
           mem_cls_queue + mem_watched + mem_lit_clauses);
 }
 
-unsigned CDatabase::mem_usage(void) {
-  int mem_lit_pool = (lit_pool_size() + lit_pool_free_space()) *
-                     sizeof(CLitPoolElement);
-  int mem_vars = sizeof(CVariable) * variables()->capacity();
-  int mem_cls = sizeof(CClause) * clauses()->capacity();
-  int mem_cls_queue = sizeof(int) * _unused_clause_idx.size();
-  int mem_watched = 0, mem_lit_clauses = 0;
+long64 CDatabase::mem_usage(void) {
+  long64 mem_lit_pool = lit_pool_capacity() * sizeof(CLitPoolElement) +
+                        _lit_pool.capacity() * sizeof(CLitPoolChunk);
+  long64 mem_vars = sizeof(CVariable) * (long64)variables()->capacity();
+  long64 mem_cls = sizeof(CClause) * (long64)clauses()->capacity();
+  long64 mem_cls_queue = sizeof(int) * (long64)_unused_clause_idx.size();
+  long64 mem_watched = 0, mem_lit_clauses = 0;
   for (unsigned i = 0, sz = variables()->size(); i < sz ;  ++i) {
     CVariable & v = variable(i);
     mem_watched        += v.watched(0).capacity() + v.watched(1).capacity();
@@ -155,6 +155,7 @@ void CDatabase::mark_clause_deleted(CClause & cl) {
   if (status == ORIGINAL_CL)
      _stats.num_del_orig_cls++;
   cl.set_status(DELETED_CL);
+  _lit_pool[lit_pool_chunk_of(cl.first_lit())].num_garbage += cl.num_lits() + 1;
   for (unsigned i = 0; i < cl.num_lits(); ++i) {
     CLitPoolElement & l = cl.literal(i);
     --variable(l.var_index()).lits_count(l.var_sign());
@@ -211,134 +212,201 @@ int CDatabase::find_unit_literal(ClauseIdx cl) {
   return unit_lit;
 }
 
-inline CLitPoolElement * CDatabase::lit_pool_begin(void) {
-  return _lit_pool_start;
-}
-
 inline CLitPoolElement * CDatabase::lit_pool_end(void) {
-  return _lit_pool_finish;
+  return _lit_pool[_lit_pool_cur].finish;
 }
 
 inline void CDatabase::lit_pool_incr_size(int size) {
-  _lit_pool_finish += size;
-  assert(_lit_pool_finish <= _lit_pool_end_storage);
+  CLitPoolChunk & chunk = _lit_pool[_lit_pool_cur];
+  chunk.finish += size;
+  assert(chunk.finish <= chunk.end_storage);
 }
 
-inline void CDatabase::lit_pool_push_back(int value) {
-  assert(_lit_pool_finish <= _lit_pool_end_storage);
-  _lit_pool_finish->val() = value;
-  ++_lit_pool_finish;
+inline int CDatabase::lit_pool_free_space(void) {
+  return _lit_pool[_lit_pool_cur].end_storage - _lit_pool[_lit_pool_cur].finish;
 }
 
-inline int CDatabase::lit_pool_size(void) {
-  return _lit_pool_finish - _lit_pool_start;
+long64 CDatabase::lit_pool_size(void) {
+  long64 size = 0;
+  for (unsigned i = 0; i < _lit_pool.size(); ++i)
+    size += _lit_pool[i].finish - _lit_pool[i].start;
+  return size;
 }
 
-inline int CDatabase::lit_pool_free_space(void) {
-  return _lit_pool_end_storage - _lit_pool_finish;
+long64 CDatabase::lit_pool_capacity(void) {
+  long64 size = 0;
+  for (unsigned i = 0; i < _lit_pool.size(); ++i)
+    size += _lit_pool[i].end_storage - _lit_pool[i].start;
+  return size;
 }
 
-inline double CDatabase::lit_pool_utilization(void) {
+double CDatabase::lit_pool_utilization(void) {
     // minus num_clauses() is because of spacing (i.e. clause indices)
   return (double)num_literals() / ((double) (lit_pool_size() - num_clauses())) ;
 }
 
-inline CLitPoolElement & CDatabase::lit_pool(int i) {
-  return _lit_pool_start[i];
+double CDatabase::lit_pool_chunk_utilization(int c) {
+  const CLitPoolChunk & chunk = _lit_pool[c];
+  int used = chunk.finish - chunk.start - 1;  // minus the dummy element
+  if (used == 0)
+    return 1;
+  return (double)(used - chunk.num_garbage) / used;
 }
 
-void CDatabase::compact_lit_pool(void) {
-  unsigned i, sz;
+int CDatabase::lit_pool_chunk_of(CLitPoolElement * lit) {
+  // the last chunk (in address order) that starts at or before lit
+  int lo = 0, hi = _lit_pool_by_addr.size() - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (_lit_pool[_lit_pool_by_addr[mid]].start <= lit)
+      lo = mid;
+    else
+      hi = mid - 1;
+  }
+  int c = _lit_pool_by_addr[lo];
+  assert(_lit_pool[c].start <= lit && lit < _lit_pool[c].finish);
+  return c;
+}
+
+int CDatabase::add_lit_pool_chunk(int min_size) {
+  double start_time = get_thread_cpu_time();
+  // the chunks double in size up to MAX_LIT_POOL_CHUNK_SIZE
+  int size = STARTUP_LIT_POOL_SIZE;
+  if (!_lit_pool.empty()) {
+    size = 2 * (_lit_pool.back().end_storage - _lit_pool.back().start);
+    if (size > MAX_LIT_POOL_CHUNK_SIZE)
+      size = MAX_LIT_POOL_CHUNK_SIZE;
+  }
+  if (size < min_size)
+    size = min_size;
+  CLitPoolChunk chunk;
+  chunk.start = (CLitPoolElement *) malloc(sizeof(CLitPoolElement) * size);
+  if (chunk.start == NULL)
+    return -1;
+  chunk.finish = chunk.start;
+  chunk.end_storage = chunk.start + size;
+  chunk.num_garbage = 0;
+  chunk.finish->val() = 0;  // set the first element as a dummy element
+  ++chunk.finish;
+  int c = _lit_pool.size();
+  _lit_pool.push_back(chunk);
+  // keep the chunk indices sorted by address for lit_pool_chunk_of()
+  _lit_pool_by_addr.push_back(c);
+  for (int i = _lit_pool_by_addr.size() - 1; i > 0 &&
+       _lit_pool[_lit_pool_by_addr[i-1]].start > chunk.start; --i)
+    swap(_lit_pool_by_addr[i-1], _lit_pool_by_addr[i]);
+  ++_stats.num_enlarge;
+  _stats.time_enlarge += get_thread_cpu_time() - start_time;
+  return c;
+}
+
+void CDatabase::compact_lit_pool_chunk(int c) {
+  double start_time = get_thread_cpu_time();
+  CLitPoolChunk & chunk = _lit_pool[c];
+  CLitPoolElement * start = chunk.start;
+  int used = chunk.finish - start;
+  vector<int> new_pos(used, -1);  // of the watched literals
+  vector<int> watched_svars;
   int new_index = 1;
-  // first do the compaction for the lit pool
-  for (i = 1, sz = lit_pool_size(); i < sz;  ++i) {
+  // first do the compaction in the chunk
+  for (int i = 1; i < used;  ++i) {
     // begin with 1 because 0 position is always 0
-    if (!lit_pool(i).is_literal() && !lit_pool(i-1).is_literal()) {
+    if (!start[i].is_literal() && !start[i-1].is_literal())
       continue;
-    } else {
-      lit_pool(new_index) = lit_pool(i);
-      ++new_index;
-    }
-  }
-  _lit_pool_finish = lit_pool_begin() + new_index;
-  // update all the pointers to the literals;
-  // 1. clean up the watched pointers from variables
-  for (i = 1, sz = variables()->size(); i < sz;  ++i) {
-    variable(i).watched(0).clear();
-    variable(i).watched(1).clear();
-  }
-  for (i = 1, sz = lit_pool_size(); i < sz;  ++i) {
-    CLitPoolElement & lit = lit_pool(i);
-    // 2. reinsert the watched pointers
+    CLitPoolElement lit = start[i];
     if (lit.is_literal()) {
       if (lit.is_watched()) {
-         int var_idx = lit.var_index();
-         int sign = lit.var_sign();
-         variable(var_idx).watched(sign).push_back(& lit_pool(i));
-       }
-    } else {  // lit is not literal
-    // 3. update the clauses' first literal pointer
+        new_pos[i] = new_index;
+        watched_svars.push_back(lit.s_var());
+      }
+    } else {
+      // update the clause's first literal pointer
       int cls_idx = lit.get_clause_index();
-      clause(cls_idx).first_lit() = &lit_pool(i) - clause(cls_idx).num_lits();
+      clause(cls_idx).first_lit() = start + new_index -
+                                    clause(cls_idx).num_lits();
+    }
+    start[new_index] = lit;
+    ++new_index;
+  }
+  chunk.finish = start + new_index;
+  chunk.num_garbage = 0;
+  // then update the watched pointers into the chunk, visiting each
+  // watched list concerned once. Pointers to deleted literals are dropped.
+  sort(watched_svars.begin(), watched_svars.end());
+  watched_svars.erase(unique(watched_svars.begin(), watched_svars.end()),
+                      watched_svars.end());
+  for (unsigned i = 0; i < watched_svars.size(); ++i) {
+    vector<CLitPoolElement *> & watched =
+      variable(watched_svars[i] >> 1).watched(watched_svars[i] & 0x1);
+    for (unsigned j = 0; j < watched.size(); ++j) {
+      if (watched[j] < start || watched[j] >= start + used)
+        continue;
+      int pos = new_pos[watched[j] - start];
+      if (pos >= 0) {
+        watched[j] = start + pos;
+      } else {
+        watched[j] = watched.back();
+        watched.pop_back();
+        --j;
+      }
     }
   }
   ++_stats.num_compact;
+  _stats.time_compact += get_thread_cpu_time() - start_time;
 }
 
-bool CDatabase::enlarge_lit_pool(void) {
+void CDatabase::compact_lit_pool(void) {
+  // compact the chunk with the most garbage, if it has enough of it
+  int worst = -1;
+  for (unsigned i = 0; i < _lit_pool.size(); ++i) {
+    if (worst < 0 || lit_pool_chunk_utilization(i) <
+                     lit_pool_chunk_utilization(worst))
+      worst = i;
+  }
+  if (lit_pool_chunk_utilization(worst) < 0.9)
+    compact_lit_pool_chunk(worst);
+}
+
+bool CDatabase::enlarge_lit_pool(int n_lits) {
   // will return true if successful, otherwise false.
-  unsigned i, sz;
-  // if memory efficiency < 2/3, we do a compaction
-  if (lit_pool_utilization() < 0.67) {
-    compact_lit_pool();
+  int c;
+  // if some chunk already has the room, continue there
+  for (c = 0; c < (int)_lit_pool.size(); ++c) {
+    if (_lit_pool[c].end_storage - _lit_pool[c].finish > n_lits + 1) {
+      _lit_pool_cur = c;
+      return true;
+    }
+  }
+  // if the memory efficiency of a chunk < 2/3, we do a compaction of it
+  int worst = 0;
+  for (c = 1; c < (int)_lit_pool.size(); ++c) {
+    if (lit_pool_chunk_utilization(c) < lit_pool_chunk_utilization(worst))
+      worst = c;
+  }
+  if (lit_pool_chunk_utilization(worst) < 0.67) {
+    compact_lit_pool_chunk(worst);
+    if (_lit_pool[worst].end_storage - _lit_pool[worst].finish > n_lits + 1)
+      _lit_pool_cur = worst;
     return true;
   }
   // otherwise we have to enlarge it.
   // first, check if memory is running out
-  int current_mem = estimate_mem_usage();
-  float grow_ratio = 1;
-  if (current_mem < _params.mem_limit / 4)
-    grow_ratio = 2;
-  else if (current_mem < _params.mem_limit /2 )
-    grow_ratio = 1.5;
-  else if (current_mem < _params.mem_limit * 0.8)
-    grow_ratio = 1.2;
-  if (grow_ratio < 1.2) {
-    if (lit_pool_utilization() < 0.9) {  // still has some garbage
-      compact_lit_pool();
+  long64 current_mem = estimate_mem_usage();
+  if (current_mem >= _params.mem_limit * 0.8) {
+    if (lit_pool_chunk_utilization(worst) < 0.9) {  // still has some garbage
+      compact_lit_pool_chunk(worst);
+      if (_lit_pool[worst].end_storage - _lit_pool[worst].finish > n_lits + 1)
+        _lit_pool_cur = worst;
       return true;
     }
     else
       return false;
   }
-  // second, make room for new lit pool.
-  CLitPoolElement * old_start = _lit_pool_start;
-  CLitPoolElement * old_finish = _lit_pool_finish;
-  int old_size = _lit_pool_end_storage - _lit_pool_start;
-  int new_size = (int)(old_size * grow_ratio);
-  _lit_pool_start = (CLitPoolElement *) realloc(_lit_pool_start,
-                                                sizeof(CLitPoolElement) *
-                                                new_size);
-  _lit_pool_finish = _lit_pool_start + (old_finish - old_start);
-  _lit_pool_end_storage = _lit_pool_start + new_size;
-
-  // update all the pointers
-  int displacement = _lit_pool_start - old_start;
-  for (i = 0; i < clauses()->size(); ++i) {
-    if (clause(i).status() != DELETED_CL)
-      clause(i).first_lit() += displacement;
-  }
-  for (i = 0, sz = variables()->size(); i < sz ;  ++i) {
-    CVariable & v = variable(i);
-    for (int j = 0; j < 2 ; ++j) {
-      int k, sz1;
-      vector<CLitPoolElement *> & watched = v.watched(j);
-      for (k = 0, sz1 = watched.size(); k < sz1 ; ++k) {
-        watched[k] += displacement;
-      }
-    }
-  }
-  ++_stats.num_enlarge;
+  // second, make room with a new chunk; nothing is moved.
+  c = add_lit_pool_chunk(n_lits + 2);
+  if (c < 0)
+    return false;
+  _lit_pool_cur = c;
   return true;
 }
 
@@ -354,7 +422,7 @@ ClauseIdx CDatabase::add_clause(int * lits, int n_lits, int gflag) {
   int new_cl;
   // a. do we need to enlarge lits pool?
   while (lit_pool_free_space() <= n_lits + 1) {
-    if (enlarge_lit_pool() == false)
+    if (enlarge_lit_pool(n_lits) == false)
       return -1;  // mem out, can't enlarge lit pool, because
       // ClauseIdx can't be -1, so it shows error.
   }
@@ -443,8 +511,9 @@ ClauseIdx CDatabase::add_clause(int * lits, int n_lits, int gflag) {
 
 void CDatabase::output_lit_pool_stats(void) {
   cout << "Lit_Pool Used " << lit_pool_size() << " Free "
-       << lit_pool_free_space()
-       << " Total " << lit_pool_size() + lit_pool_free_space()
+       << lit_pool_capacity() - lit_pool_size()
+       << " Total " << lit_pool_capacity()
+       << " Chunks " << _lit_pool.size()
        << " Num. Cl " << num_clauses() << " Num. Lit " << num_literals()
        << " Efficiency " <<  lit_pool_utilization() << endl;
 }
@@ -38,6 +38,7 @@
 #include "zchaff_base.h"
 
 #define STARTUP_LIT_POOL_SIZE 0x8000
+#define MAX_LIT_POOL_CHUNK_SIZE 0x100000   // 4 MB, bounds compaction latency
 
 // **Struct********************************************************************
 //
@@ -60,6 +61,30 @@ struct CDatabaseStats {
   long64           num_deleted_literals;
   unsigned         num_compact;
   unsigned         num_enlarge;
+  double           time_compact;      // cpu seconds spent in compaction
+  double           time_enlarge;      // cpu seconds spent in allocating chunks
+};
+
+// **Struct********************************************************************
+//
+//  Synopsis    [A chunk of the lit pool]
+//
+//  Description [The lit pool is a list of chunks that are never moved, so
+//               the pointers to literals (clauses' first_lit and the watched
+//               lists) stay valid when the pool grows. Each chunk begins
+//               with a dummy 0 element, and a clause never spans two
+//               chunks, so that BCP always meets a non-literal at either
+//               end of a clause.]
+//
+//  SeeAlso     [CDatabase]
+//
+// ****************************************************************************
+
+struct CLitPoolChunk {
+  CLitPoolElement * start;          // the begin of the chunk
+  CLitPoolElement * finish;         // the tail of the used part
+  CLitPoolElement * end_storage;    // the storage end of the chunk
+  int               num_garbage;    // elements of deleted clauses in it
 };
 
 // **Struct********************************************************************
@@ -73,7 +98,7 @@ struct CDatabaseStats {
 // ****************************************************************************
 
 struct CDatabaseParams {
-  int         mem_limit;
+  long64      mem_limit;                // in bytes
 };
 
 // **Class*********************************************************************
@@ -97,9 +122,9 @@ class CDatabase {
                                            // allocated
 
     // for efficiency, the memeory management of lit pool is done by the solver
-    CLitPoolElement * _lit_pool_start;     // the begin of the lit vector
-    CLitPoolElement * _lit_pool_finish;    // the tail of the used lit vector
-    CLitPoolElement * _lit_pool_end_storage;  // the storage end of lit vector
+    vector<CLitPoolChunk> _lit_pool;        // the chunks, in allocation order
+    vector<int>         _lit_pool_by_addr;  // chunk indices sorted by start
+    int                 _lit_pool_cur;      // the chunk new clauses go to
 
 
     vector<CVariable>   _variables;     // note: first element is not used
@@ -125,32 +150,42 @@ class CDatabase {
       _stats.num_deleted_literals     = 0;
       _stats.num_enlarge              = 0;
       _stats.num_compact              = 0;
+      _stats.time_enlarge             = 0;
+      _stats.time_compact             = 0;
     }
 
-    // lit pool naming convention follows STL Vector
-    CLitPoolElement * lit_pool_begin(void);
-
+    // lit pool naming convention follows STL Vector; lit_pool_end(),
+    // lit_pool_incr_size() and lit_pool_free_space() are about the
+    // current chunk, the others about the whole pool
     CLitPoolElement * lit_pool_end(void);
 
     void lit_pool_incr_size(int size);
 
-    void lit_pool_push_back(int value);
-
-    int lit_pool_size(void);
+    long64 lit_pool_size(void);
 
     int lit_pool_free_space(void);
 
+    long64 lit_pool_capacity(void);
+
     double lit_pool_utilization(void);
 
-    CLitPoolElement & lit_pool(int i);
+    double lit_pool_chunk_utilization(int c);
+
+    int lit_pool_chunk_of(CLitPoolElement * lit);
 
     // functions on lit_pool
     void output_lit_pool_stats(void);
 
-    // when allocated memeory runs out, do a reallocation
-    bool enlarge_lit_pool(void);
+    // when the current chunk has no room for n_lits literals and the
+    // spacing element, switch to a chunk that has: one with free space
+    // left, a compacted one or a new one
+    bool enlarge_lit_pool(int n_lits);
+
+    int add_lit_pool_chunk(int min_size);
 
-    void compact_lit_pool(void);        // garbage collection
+    void compact_lit_pool_chunk(int c);
+
+    void compact_lit_pool(void);        // garbage collection (one chunk)
 
     unsigned literal_value(CLitPoolElement l) {
     // note: it will return 0 or 1 or other, here "other" may not equal UNKNOWN
@@ -201,7 +236,7 @@ class CDatabase {
       return _stats;
     }
 
-    inline void set_mem_limit(int n) {
+    inline void set_mem_limit(long64 n) {
       _params.mem_limit = n;
     }
 
@@ -271,10 +306,18 @@ class CDatabase {
       _stats.num_enlarge;
     }
 
+    inline double time_mem_compacts(void) {
+      return _stats.time_compact;
+    }
+
+    inline double time_mem_enlarges(void) {
+      return _stats.time_enlarge;
+    }
+
     // functions
-    unsigned estimate_mem_usage(void);
+    long64 estimate_mem_usage(void);
 
-    unsigned mem_usage(void);
+    long64 mem_usage(void);
 
     inline void set_variable_number(int n) {
       variables()->resize(n + 1);
@@ -71,5 +71,6 @@ typedef long            long64;
 void fatal(const char * fun, const char * file, int lineno, const char * fmt, ...);
 void warning(const char * fun, const char * file, int lineno, const char * fmt, ...);
 double get_cpu_time(void);
+double get_thread_cpu_time(void);
 
 #endif
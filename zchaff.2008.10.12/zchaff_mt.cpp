@@ -0,0 +1,225 @@
+// *********************************************************************
+// Copyright 2000-2004, Princeton University.  All rights reserved.
+// By using this software the USER indicates that he or she has read,
+// understood and will comply with the following:
+//
+// --- Princeton University hereby grants USER nonexclusive permission
+// to use, copy and/or modify this software for internal, noncommercial,
+// research purposes only. Any distribution, including commercial sale
+// or license, of this software, copies of the software, its associated
+// documentation and/or modifications of either is strictly prohibited
+// without the prior consent of Princeton University.  Title to copyright
+// to this software and its associated documentation shall at all times
+// remain with Princeton University.  Appropriate copyright notice shall
+// be placed on all software copies, and a complete copy of this notice
+// shall be included in all copies of the associated documentation.
+// No right is  granted to use in advertising, publicity or otherwise
+// any trademark,  service mark, or the name of Princeton University.
+//
+//
+// --- This software and any associated documentation is provided "as is"
+//
+// PRINCETON UNIVERSITY MAKES NO REPRESENTATIONS OR WARRANTIES, EXPRESS
+// OR IMPLIED, INCLUDING THOSE OF MERCHANTABILITY OR FITNESS FOR A
+// PARTICULAR PURPOSE, OR THAT  USE OF THE SOFTWARE, MODIFICATIONS, OR
+// ASSOCIATED DOCUMENTATION WILL NOT INFRINGE ANY PATENTS, COPYRIGHTS,
+// TRADEMARKS OR OTHER INTELLECTUAL PROPERTY RIGHTS OF A THIRD PARTY.
+//
+// Princeton University shall not be liable under any circumstances for
+// any direct, indirect, special, incidental, or consequential damages
+// with respect to any claim by USER or any third party on account of
+// or arising from the use, or inability to use, this software or its
+// associated documentation, even if Princeton University has been advised
+// of the possibility of those damages.
+// *********************************************************************
+
+
+// A portfolio driver and stress test of the SAT_Manager interface: each
+// round solves the same CNF with several managers, one thread each, with
+// different random seeds. The first manager to finish interrupts the
+// others (unless -wait is given). The answers of all the managers that
+// finished must agree, and their satisfying assignments must satisfy the
+// CNF.
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+#include "SAT.h"
+
+typedef vector<int> Clause;
+
+int read_cnf(const char * filename, vector<Clause> & clauses) {
+  ifstream inp(filename, ios::in);
+  if (!inp) {
+    cerr << "Can't open input file " << filename << endl;
+    exit(1);
+  }
+  int num_vars = 0;
+  set<int> clause_vars;
+  set<int> clause_lits;
+  string word;
+  while (inp >> word) {
+    if (word == "c") {
+      getline(inp, word);
+    } else if (word == "p") {
+      int num_cls;
+      if (!(inp >> word >> num_vars >> num_cls) || word != "cnf") {
+        cerr << "Unable to read number of variables and clauses" << endl;
+        exit(3);
+      }
+    } else {
+      int var_idx = atoi(word.c_str());
+      if (var_idx != 0) {
+        int sign = 0;
+        if (var_idx < 0) {
+          var_idx = -var_idx;
+          sign = 1;
+        }
+        if (var_idx > num_vars) {
+          cerr << "Variable " << var_idx << " out of range" << endl;
+          exit(3);
+        }
+        clause_vars.insert(var_idx);
+        clause_lits.insert((var_idx << 1) + sign);
+      } else {
+        // a clause that has a var of both polarities is skipped
+        if (clause_vars.size() != 0 &&
+            clause_vars.size() == clause_lits.size())
+          clauses.push_back(Clause(clause_lits.begin(), clause_lits.end()));
+        clause_vars.clear();
+        clause_lits.clear();
+      }
+    }
+  }
+  if (clause_vars.size() != 0 && clause_vars.size() == clause_lits.size())
+    clauses.push_back(Clause(clause_lits.begin(), clause_lits.end()));
+  return num_vars;
+}
+
+bool verify_solution(SAT_Manager mng, const vector<Clause> & clauses) {
+  for (unsigned i = 0; i < clauses.size(); ++i) {
+    unsigned j;
+    for (j = 0; j < clauses[i].size(); ++j) {
+      int lit = clauses[i][j];
+      if (SAT_GetVarAsgnment(mng, lit >> 1) == ((lit & 0x1) ^ 0x1))
+        break;
+    }
+    if (j == clauses[i].size())
+      return false;
+  }
+  return true;
+}
+
+const char * outcome_name(int outcome) {
+  switch (outcome) {
+    case UNDETERMINED:  return "UNDETERMINED";
+    case UNSATISFIABLE: return "UNSAT";
+    case SATISFIABLE:   return "SAT";
+    case TIME_OUT:      return "TIME_OUT";
+    case MEM_OUT:       return "MEM_OUT";
+    case ABORTED:       return "ABORTED";
+  }
+  return "UNKNOWN";
+}
+
+int main(int argc, char ** argv) {
+  bool wait = false;
+  int arg = 1;
+  if (arg < argc && strcmp(argv[arg], "-wait") == 0) {
+    wait = true;
+    ++arg;
+  }
+  if (arg >= argc) {
+    cerr << "Usage: " << argv[0]
+         << " [-wait] cnf_file [num_threads [num_rounds]]" << endl;
+    return 2;
+  }
+  const char * filename = argv[arg++];
+  int num_threads = arg < argc ? atoi(argv[arg++]) : 8;
+  int num_rounds = arg < argc ? atoi(argv[arg++]) : 1;
+  if (num_threads < 1 || num_rounds < 1) {
+    cerr << "The numbers of threads and rounds must be positive" << endl;
+    return 2;
+  }
+
+  vector<Clause> clauses;
+  int num_vars = read_cnf(filename, clauses);
+  cout << "Solving " << filename << " (" << num_vars << " vars, "
+       << clauses.size() << " clauses) with " << num_threads
+       << " managers, " << num_rounds << " round(s)" << endl;
+
+  bool failed = false;
+  for (int round = 0; round < num_rounds; ++round) {
+    // the managers are created and released here, so that the interrupts
+    // never meet a released manager
+    vector<SAT_Manager> managers(num_threads);
+    vector<int> outcomes(num_threads, UNDETERMINED);
+    vector<char> verified(num_threads, true);  // no vector<bool>: shared bytes
+    for (int t = 0; t < num_threads; ++t)
+      managers[t] = SAT_InitManager();
+    atomic<int> winner(-1);
+
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.push_back(thread([&, t]() {
+        SAT_Manager mng = managers[t];
+        SAT_SetNumVariables(mng, num_vars);
+        for (unsigned i = 0; i < clauses.size(); ++i)
+          SAT_AddClause(mng, const_cast<int *>(&clauses[i][0]),
+                        clauses[i].size());
+        // manager 0 is the plain solver, the others are randomized
+        SAT_SetRandomness(mng, t == 0 ? 0 : 1 + t % 10);
+        SAT_SetRandSeed(mng, round * num_threads + t);
+        int outcome = SAT_Solve(mng);
+        outcomes[t] = outcome;
+        if (outcome == SATISFIABLE)
+          verified[t] = verify_solution(mng, clauses);
+        if (outcome != SATISFIABLE && outcome != UNSATISFIABLE)
+          return;
+        int none = -1;
+        if (winner.compare_exchange_strong(none, t) && !wait)
+          for (int o = 0; o < num_threads; ++o)
+            if (o != t)
+              SAT_Interrupt(managers[o]);
+      }));
+    }
+    for (int t = 0; t < num_threads; ++t)
+      threads[t].join();
+
+    int answer = winner >= 0 ? outcomes[winner] : UNDETERMINED;
+    int num_finished = 0;
+    for (int t = 0; t < num_threads; ++t) {
+      if (outcomes[t] == SATISFIABLE || outcomes[t] == UNSATISFIABLE) {
+        ++num_finished;
+        if (outcomes[t] != answer) {
+          cerr << "Manager " << t << " answered " << outcome_name(outcomes[t])
+               << ", manager " << winner << " " << outcome_name(answer)
+               << endl;
+          failed = true;
+        }
+      } else if (wait || outcomes[t] != ABORTED) {
+        cerr << "Manager " << t << " ended with "
+             << outcome_name(outcomes[t]) << endl;
+        failed = true;
+      }
+      if (!verified[t]) {
+        cerr << "Manager " << t << " found a wrong solution" << endl;
+        failed = true;
+      }
+      SAT_ReleaseManager(managers[t]);
+    }
+    cout << "Round " << round << ": " << outcome_name(answer)
+         << " by manager " << winner << ", " << num_finished << "/"
+         << num_threads << " managers finished" << endl;
+  }
+  cout << "RESULT:\t" << (failed ? "FAILED" : "OK") << endl;
+  return failed ? 1 : 0;
+}
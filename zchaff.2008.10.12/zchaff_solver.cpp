@@ -47,10 +47,6 @@ using namespace std;
 
 // #define VERIFY_ON
 
-#ifdef VERIFY_ON
-ofstream verify_out("resolve_trace");
-#endif
-
 void CSolver::re_init_stats(void) {
   _stats.is_mem_out           = false;
   _stats.outcome              = UNDETERMINED;
@@ -71,9 +67,8 @@ void CSolver::re_init_stats(void) {
   _stats.num_restarts                 = 0;
   _stats.num_del_orig_cls             = 0;
   _stats.num_shrinkings               = 0;
-  _stats.start_cpu_time               = get_cpu_time();
+  _stats.start_cpu_time               = get_thread_cpu_time();
   _stats.finish_cpu_time              = 0;
-  _stats.random_seed                  = 0;
 }
 
 void CSolver::init_stats(void) {
@@ -82,6 +77,7 @@ void CSolver::init_stats(void) {
   _stats.been_reset                   = true;
   _stats.num_free_variables           = 0;
   _stats.num_free_branch_vars         = 0;
+  _stats.random_seed                  = 0;
 }
 
 void CSolver::init_parameters(void) {
@@ -118,27 +114,27 @@ CSolver::CSolver(void) {
   init_parameters();
   init_stats();
   _dlevel                       = 0;
+  _top_level                    = 0;
   _force_terminate              = false;
   _implication_id               = 0;
   _num_marked                   = 0;
   _num_in_new_cl                = 0;
   _outside_constraint_hook      = NULL;
   _sat_hook                     = NULL;
+  _random_state                 = 0;
+  _trace_file                   = "resolve_trace";
 }
 
 CSolver::~CSolver(void) {
-  while (!_assignment_stack.empty()) {
-    delete _assignment_stack.back();
-    _assignment_stack.pop_back();
-  }
 }
 
 void CSolver::set_time_limit(float t) {
   _params.time_limit = t;
 }
 
+// the cpu times are those of the thread that runs solve()
 float CSolver::elapsed_cpu_time(void) {
-  return get_cpu_time() - _stats.start_cpu_time;
+  return get_thread_cpu_time() - _stats.start_cpu_time;
 }
 
 float CSolver::cpu_run_time(void) {
@@ -149,21 +145,18 @@ void CSolver::set_variable_number(int n) {
   assert(num_variables() == 0);
   CDatabase::set_variable_number(n);
   _stats.num_free_variables = num_variables();
-  while (_assignment_stack.size() <= num_variables())
-    _assignment_stack.push_back(new vector<int>);
-  assert(_assignment_stack.size() == num_variables() + 1);
+  _assignment_stack.reserve(num_variables());
+  _level_start.resize(num_variables() + 1, 0);
 }
 
 int CSolver::add_variable(void) {
   int num = CDatabase::add_variable();
   ++_stats.num_free_variables;
-  while (_assignment_stack.size() <= num_variables())
-    _assignment_stack.push_back(new vector<int>);
-  assert(_assignment_stack.size() == num_variables() + 1);
+  _level_start.resize(num_variables() + 1, 0);
   return num;
 }
 
-void CSolver::set_mem_limit(int s) {
+void CSolver::set_mem_limit(long64 s) {
   CDatabase::set_mem_limit(s);
 }
 
@@ -172,7 +165,11 @@ void CSolver::set_randomness(int n) {
 }
 
 void CSolver::set_random_seed(int seed) {
-  srand(seed);
+  _stats.random_seed = seed;
+}
+
+void CSolver::set_trace_file(const char * filename) {
+  _trace_file = filename;
 }
 
 void CSolver::enable_cls_deletion(bool allow) {
@@ -193,8 +190,8 @@ void CSolver::run_periodic_functions(void) {
     restart();
     if (_stats.num_restarts % 5 == 1)
       compact_lit_pool();
-    cout << "\rDecision: " << _assignment_stack[0]->size() << "/"
-         <<num_variables() << "\tTime: " << get_cpu_time() -
+    cout << "\rDecision: " << level_end(0) << "/"
+         <<num_variables() << "\tTime: " << get_thread_cpu_time() -
            _stats.start_cpu_time << "/" << _params.time_limit << flush;
   }
 
@@ -234,7 +231,12 @@ void CSolver::init_solve(void) {
   _ordered_vars.resize(num_variables());
   update_var_score();
 
-  set_random_seed(_stats.random_seed);
+  _random_state = _stats.random_seed;
+
+#ifdef VERIFY_ON
+  if (!_verify_out.is_open())
+    _verify_out.open(_trace_file.c_str());
+#endif
 
   top_unsat_cls = clauses()->size() - 1;
 
@@ -252,8 +254,10 @@ void CSolver::set_var_value(int v, int value, ClauseIdx ante, int dl) {
     var.set_dlevel(dl);
     var.set_value(value);
     var.antecedent() = ante;
-    var.assgn_stack_pos() = _assignment_stack[dl]->size();
-    _assignment_stack[dl]->push_back(v * 2 + !value);
+    while (_top_level < dl)
+      _level_start[++_top_level] = _assignment_stack.size();
+    var.assgn_stack_pos() = _assignment_stack.size();
+    _assignment_stack.push_back(v * 2 + !value);
     set_var_value_BCP(v, value);
 
     ++_stats.num_implications ;
@@ -329,9 +333,9 @@ void CSolver::dump_assignment_stack(ostream & os ) {
   os << "Assignment Stack:  ";
   for (int i = 0; i <= dlevel(); ++i) {
     os << "(" <<i << ":";
-    for (unsigned j = 0; j < (*_assignment_stack[i]).size(); ++j) {
-      os << ((*_assignment_stack[i])[j]&0x1?"-":"+")
-         << ((*_assignment_stack[i])[j] >> 1) << " ";
+    for (int j = level_begin(i), end = level_end(i); j < end; ++j) {
+      os << (_assignment_stack[j]&0x1?"-":"+")
+         << (_assignment_stack[j] >> 1) << " ";
     }
     os << ") " << endl;
   }
@@ -396,8 +400,7 @@ void CSolver::reset(void) {
     return;
   back_track(0);
   _conflicts.clear();
-  while (!_implication_queue.empty())
-    _implication_queue.pop();
+  _implication_queue.clear();
 
   _stats.outcome = UNDETERMINED;
   _stats.been_reset = true;
@@ -526,7 +529,7 @@ void CSolver::delete_unrelevant_clauses(void) {
 }
 
 bool CSolver::time_out(void) {
-  return (get_cpu_time() - _stats.start_cpu_time> _params.time_limit);
+  return (get_thread_cpu_time() - _stats.start_cpu_time> _params.time_limit);
 }
 
 void CSolver::adjust_variable_order(int * lits, int n_lits) {
@@ -580,7 +583,7 @@ void CSolver::decay_variable_score(void) {
 
 bool CSolver::decide_next_branch(void) {
   if (dlevel() > 0)
-    assert(_assignment_stack[dlevel()]->size() > 0);
+    assert(level_end(dlevel()) > level_begin(dlevel()));
   if (!_implication_queue.empty()) {
     // some hook function did a decision, so skip my own decision making.
     // if the front of implication queue is 0, that means it's finished
@@ -656,7 +659,7 @@ bool CSolver::decide_next_branch(void) {
       if (v.two_lits_count(0) > v.two_lits_count(1))
         s_var+=1;
       else if (v.two_lits_count(0) == v.two_lits_count(1))
-        s_var+=rand()%2;
+        s_var+=random_int()%2;
     }
     assert(s_var >= 2);
     queue_implication(s_var, NULL_CLAUSE);
@@ -675,7 +678,7 @@ bool CSolver::decide_next_branch(void) {
       int randomness = _stats.current_randomness;
       if (randomness >= num_free_variables())
         randomness = num_free_variables() - 1;
-      int skip = rand() % (1 + randomness);
+      int skip = random_int() % (1 + randomness);
       int index = i;
       while (skip > 0) {
         ++index;
@@ -692,7 +695,7 @@ bool CSolver::decide_next_branch(void) {
         if (ptr->two_lits_count(0) > ptr->two_lits_count(1))
           sign += 1;
         else if (ptr->two_lits_count(0) == ptr->two_lits_count(1))
-          sign += rand() % 2;
+          sign += random_int() % 2;
       }
       int var_idx = ptr - &(*variables()->begin());
       s_var = var_idx + var_idx + sign;
@@ -774,28 +777,28 @@ int CSolver::preprocess(void) {
         int ante_id = 0;
         if (ante >= 0) {
           ante_id = clause(ante).id();
-          verify_out << "VAR: " << i
+          _verify_out << "VAR: " << i
                      << " L: " << variable(i).assgn_stack_pos()
                      << " V: " << variable(i).value()
                      << " A: " << ante_id
                      << " Lits:";
           for (unsigned j = 0; j < clause(ante).num_lits(); ++j)
-            verify_out <<" " <<  clause(ante).literal(j).s_var();
-          verify_out << endl;
+            _verify_out <<" " <<  clause(ante).literal(j).s_var();
+          _verify_out << endl;
          }
        }
     }
-    verify_out << "CONF: " << clause(_conflicts[0]).id() << " ==";
+    _verify_out << "CONF: " << clause(_conflicts[0]).id() << " ==";
     for (unsigned i = 0; i < clause(_conflicts[0]).num_lits(); ++i) {
       int svar = clause(_conflicts[0]).literal(i).s_var();
-      verify_out << " " << svar;
+      _verify_out << " " << svar;
     }
-    verify_out << endl;
+    _verify_out << endl;
 #endif
     return CONFLICT;
   }
   if (_params.verbosity > 1) {
-    cout << _assignment_stack[0]->size() << " vars set during preprocess; "
+    cout << level_end(0) << " vars set during preprocess; "
          << endl;
   }
   return NO_CONFLICT;
@@ -902,19 +905,19 @@ int CSolver::solve(void) {
     else  // the real search
       real_solve();
     cout << endl;
-    _stats.finish_cpu_time = get_cpu_time();
+    _stats.finish_cpu_time = get_thread_cpu_time();
   }
   return _stats.outcome;
 }
 
 void CSolver::back_track(int blevel) {
   assert(blevel <= dlevel());
-  for (int i = dlevel(); i >= blevel; --i) {
-    vector<int> & assignments = *_assignment_stack[i];
-    for (int j = assignments.size() - 1 ; j >= 0; --j)
-      unset_var_value(assignments[j]>>1);
-    assignments.clear();
-  }
+  int begin = level_begin(blevel);
+  for (int j = _assignment_stack.size() - 1; j >= begin; --j)
+    unset_var_value(_assignment_stack[j]>>1);
+  _assignment_stack.resize(begin);
+  if (_top_level >= blevel)
+    _top_level = blevel > 0 ? blevel - 1 : 0;
   dlevel() = blevel - 1;
   if (dlevel() < 0 )
     dlevel() = 0;
@@ -951,8 +954,7 @@ int CSolver::deduce(void) {
     }
   }
   // if loop exited because of a conflict, we need to clean implication queue
-  while (!_implication_queue.empty())
-    _implication_queue.pop();
+  _implication_queue.clear();
   return (_conflicts.size() ? CONFLICT : NO_CONFLICT);
 }
 
@@ -962,7 +964,8 @@ void CSolver::verify_integrity(void) {
       int pos = variable(i).assgn_stack_pos();
       int value = variable(i).value();
       int dlevel = variable(i).dlevel();
-      assert((*_assignment_stack[dlevel])[pos] == (int) (i+i+1-value));
+      assert(level_begin(dlevel) <= pos && pos < level_end(dlevel));
+      assert(_assignment_stack[pos] == (int) (i+i+1-value));
     }
   }
   for (unsigned i = 0; i < clauses()->size(); ++i) {
@@ -1070,14 +1073,14 @@ int CSolver::analyze_conflicts(void) {
         if (ante >= 0) {
           ante_id = clause(ante).id();
           assert(clause(ante).status() != DELETED_CL);
-          verify_out << "VAR: " << i
+          _verify_out << "VAR: " << i
                      << " L: " << variable(i).assgn_stack_pos()
                      << " V: " << variable(i).value()
                      << " A: " << ante_id
                      << " Lits:";
           for (unsigned j = 0; j < clause(ante).num_lits(); ++j)
-            verify_out << " " << clause(ante).literal(j).s_var();
-          verify_out << endl;
+            _verify_out << " " << clause(ante).literal(j).s_var();
+          _verify_out << endl;
         }
       }
     }
@@ -1091,12 +1094,12 @@ int CSolver::analyze_conflicts(void) {
       }
       _conflicts.pop_back();
     }
-    verify_out << "CONF: " << clause(shortest).id() << " ==";
+    _verify_out << "CONF: " << clause(shortest).id() << " ==";
     for (unsigned i = 0; i < clause(shortest).num_lits(); ++i) {
       int svar = clause(shortest).literal(i).s_var();
-      verify_out << " " << svar;
+      _verify_out << " " << svar;
     }
-    verify_out << endl;
+    _verify_out << endl;
 #endif
     _conflicts.clear();
     back_track(0);
@@ -1121,10 +1124,10 @@ int CSolver::finish_add_conf_clause(int gflag) {
   top_unsat_cls = clauses()->size() - 1;
 
 #ifdef VERIFY_ON
-  verify_out << "CL: " <<  clause(added_cl).id() << " <=";
+  _verify_out << "CL: " <<  clause(added_cl).id() << " <=";
   for (unsigned i = 0; i< _resolvents.size(); ++i)
-        verify_out << " " <<  _resolvents[i];
-    verify_out << endl;
+        _verify_out << " " <<  _resolvents[i];
+    _verify_out << endl;
     _resolvents.clear();
 #endif
 
@@ -1245,10 +1248,10 @@ int CSolver::conflict_analysis_firstUIP(void) {
       cl = *ci;
       mark_vars(cl, -1);
       // current dl must be the conflict cl.
-      vector <int> & assignments = *_assignment_stack[dlevel()];
       // now add conflict lits, and unassign vars
-      for (int i = assignments.size() - 1; i >= 0; --i) {
-        int assigned = assignments[i];
+      for (int i = _assignment_stack.size() - 1,
+               begin = level_begin(dlevel()); i >= begin; --i) {
+        int assigned = _assignment_stack[i];
         if (variable(assigned >> 1).is_marked()) {
           // this variable is involved in the conflict clause or its antecedent
           variable(assigned>>1).clear_marked();
@@ -1295,9 +1298,9 @@ int CSolver::conflict_analysis_firstUIP(void) {
   _mark_increase_score = true;
   mark_vars(cl, -1);
   gflag = clause(cl).gflag();
-  vector <int> & assignments = *_assignment_stack[dlevel()];
-  for (int i = assignments.size() - 1; i >= 0; --i) {
-    int assigned = assignments[i];
+  for (int i = _assignment_stack.size() - 1, begin = level_begin(dlevel());
+       i >= begin; --i) {
+    int assigned = _assignment_stack[i];
     if (variable(assigned >> 1).is_marked()) {
       variable(assigned>>1).clear_marked();
       --_num_marked;
@@ -1339,19 +1342,18 @@ void CSolver::print_cls(ostream & os) {
   }
 }
 
-int CSolver::mem_usage(void) {
-  int mem_dbase = CDatabase::mem_usage();
-  int mem_assignment = 0;
-  for (int i = 0; i < _stats.max_dlevel; ++i)
-    mem_assignment += _assignment_stack[i]->capacity() * sizeof(int);
-  mem_assignment += sizeof(vector<int>)* _assignment_stack.size();
+long64 CSolver::mem_usage(void) {
+  long64 mem_dbase = CDatabase::mem_usage();
+  long64 mem_assignment = 0;
+  mem_assignment += _assignment_stack.capacity() * sizeof(int);
+  mem_assignment += _level_start.capacity() * sizeof(int);
   return mem_dbase + mem_assignment;
 }
 
 void CSolver::clean_up_dbase(void) {
   assert(dlevel() == 0);
 
-  int mem_before = mem_usage();
+  long64 mem_before = mem_usage();
   // 1. remove all the learned clauses
   for (vector<CClause>::iterator itr = clauses()->begin();
        itr != clauses()->end() - 1; ++itr) {
@@ -1369,7 +1371,8 @@ void CSolver::clean_up_dbase(void) {
       watched.reserve(old_watched.size());
       for (vector<CLitPoolElement *>::iterator itr = old_watched.begin();
            itr != old_watched.end(); ++itr)
-        watched.push_back(*itr);
+        if ((*itr)->val() > 0)  // drop the literals of deleted clauses
+          watched.push_back(*itr);
         // because watched is a temp mem allocation, it will get deleted
         // out of the scope, but by swap it with the old_watched, the
         // contents are reserved.
@@ -1386,7 +1389,7 @@ void CSolver::clean_up_dbase(void) {
     }
   }
 
-  int mem_after = mem_usage();
+  long64 mem_after = mem_usage();
   if (_params.verbosity > 0) {
     cout << "Database Cleaned, releasing (approximately) "
          << mem_before - mem_after << " Bytes" << endl;
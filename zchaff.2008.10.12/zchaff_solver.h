@@ -36,6 +36,10 @@
 #ifndef __SAT_SOLVER__
 #define __SAT_SOLVER__
 
+#include <stdlib.h>
+#include <atomic>
+#include <string>
+
 #include "zchaff_version.h"
 #include "zchaff_dbase.h"
 
@@ -185,29 +189,86 @@ struct CImplication {
   int antecedent;
 };
 
-struct ImplicationQueue:queue<CImplication> {
-  void dump(ostream & os) {
-    queue<CImplication> temp(*this);
-    os << "Implication Queue Previous: " ;
-    while (!temp.empty()) {
-      CImplication a = temp.front();
-      os << "(" << ((a.lit & 0x1) ? "-" : "+") << (a.lit >> 1)
-         << ":" << a.antecedent << ")  ";
-      temp.pop();
+// FIFO of pending implications in a ring buffer. The buffer only grows
+// (doubling its power-of-two size), so the queue allocates nothing once it
+// has reached its working size.
+class ImplicationQueue {
+  protected:
+    vector<CImplication> _buf;
+    unsigned             _head;      // index of the front element
+    unsigned             _size;      // number of queued elements
+
+    void grow(void) {
+      vector<CImplication> buf(_buf.empty() ? 256 : 2 * _buf.size());
+      for (unsigned i = 0; i < _size; ++i)
+        buf[i] = _buf[(_head + i) & (_buf.size() - 1)];
+      _buf.swap(buf);
+      _head = 0;
+    }
+
+  public:
+    ImplicationQueue(void) : _head(0), _size(0) {}
+
+    inline bool empty(void) const {
+      return _size == 0;
+    }
+
+    inline unsigned size(void) const {
+      return _size;
+    }
+
+    inline const CImplication & front(void) const {
+      assert(_size > 0);
+      return _buf[_head];
+    }
+
+    inline void push(const CImplication & imp) {
+      if (_size == _buf.size())
+        grow();
+      _buf[(_head + _size) & (_buf.size() - 1)] = imp;
+      ++_size;
+    }
+
+    inline void pop(void) {
+      assert(_size > 0);
+      _head = (_head + 1) & (_buf.size() - 1);
+      --_size;
+    }
+
+    inline void clear(void) {
+      _head = 0;
+      _size = 0;
+    }
+
+    void dump(ostream & os) {
+      os << "Implication Queue Previous: " ;
+      for (unsigned i = 0; i < _size; ++i) {
+        const CImplication & a = _buf[(_head + i) & (_buf.size() - 1)];
+        os << "(" << ((a.lit & 0x1) ? "-" : "+") << (a.lit >> 1)
+           << ":" << a.antecedent << ")  ";
+      }
     }
-  }
 };
 
 class CSolver:public CDatabase {
   protected:
     int                 _id;                  // the id of the solver, in case
                                               // we need to distinguish
-    bool                _force_terminate;
+    atomic<bool>        _force_terminate;     // may be set from other threads
     CSolverParameters   _params;              // parameters for the solver
     CSolverStats        _stats;               // statistics and states
 
+    unsigned            _random_state;        // for rand_r(), rand() is
+                                              // shared by all the solvers
+    ofstream            _verify_out;          // the resolve trace, written
+    string              _trace_file;          // only if VERIFY_ON
+
     int                 _dlevel;              // current decision elvel
-    vector<vector<int>*>_assignment_stack;
+    vector<int>         _assignment_stack;    // assigned lits of all levels
+    vector<int>         _level_start;         // where each level begins in
+                                              // _assignment_stack
+    int                 _top_level;           // highest level that has an
+                                              // entry in _level_start
     queue<int>          _recent_shrinkings;
     bool                _mark_increase_score;  // used in mark_vars during
                                               // multiple conflict analysis
@@ -265,6 +326,24 @@ class CSolver:public CDatabase {
     void set_var_value_BCP(int v, int value);
     void unset_var_value(int var);
 
+    // the assignments of level dl are _assignment_stack[level_begin(dl)]
+    // up to (excluding) _assignment_stack[level_end(dl)]. A level gets its
+    // entry in _level_start with its first assignment, since dlevel() may
+    // be raised without assigning anything.
+    inline int level_begin(int dl) {
+      return dl <= _top_level ? _level_start[dl] :
+                                (int)_assignment_stack.size();
+    }
+
+    inline int level_end(int dl) {
+      return dl < _top_level ? _level_start[dl + 1] :
+                               (int)_assignment_stack.size();
+    }
+
+    inline int random_int(void) {
+      return rand_r(&_random_state);
+    }
+
     // misc functions
     bool time_out(void);
     void delete_unrelevant_clauses(void);
@@ -277,10 +356,11 @@ class CSolver:public CDatabase {
 
     // member access function
     void set_time_limit(float t);
-    void set_mem_limit(int s);
+    void set_mem_limit(long64 s);
     void enable_cls_deletion(bool allow);
     void set_randomness(int n) ;
     void set_random_seed(int seed);
+    void set_trace_file(const char * filename);
 
     void set_variable_number(int n);
     int add_variable(void) ;
@@ -341,11 +421,11 @@ class CSolver:public CDatabase {
 
     float elapsed_cpu_time(void);
     float cpu_run_time(void) ;
-    int estimate_mem_usage(void) {
+    long64 estimate_mem_usage(void) {
       return CDatabase::estimate_mem_usage();
     }
 
-    int mem_usage(void);
+    long64 mem_usage(void);
 
     void queue_implication(int lit, ClauseIdx ante_clause) {
       CImplication i;
@@ -363,6 +443,9 @@ class CSolver:public CDatabase {
       _id = i;
     }
 
+    // thread safe: a solve() running in another thread stops at its next
+    // decision with outcome ABORTED. The flag stays set until it is unset,
+    // so that it is not lost if solve() has not started yet.
     inline void force_terminate(void) {
       _force_terminate = true;
     }
@@ -78,12 +78,26 @@ void warning(const char * fun, const char * file, int lineno, const char * fmt,
   fflush(stderr);
 }
 
-double get_cpu_time(void) {
+static double rusage_time(int who) {
   double res;
   struct rusage usage;
-  getrusage(RUSAGE_SELF, &usage);
+  getrusage(who, &usage);
   res = usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
   res *= 1e-6;
   res += usage.ru_utime.tv_sec + usage.ru_stime.tv_sec;
   return res;
 }
+
+double get_cpu_time(void) {
+  return rusage_time(RUSAGE_SELF);
+}
+
+// the cpu time of the calling thread only, so that the time limits of
+// solvers running in parallel threads don't count each other's time
+double get_thread_cpu_time(void) {
+#ifdef RUSAGE_THREAD
+  return rusage_time(RUSAGE_THREAD);
+#else
+  return rusage_time(RUSAGE_SELF);
+#endif
+}
@@ -33,25 +33,46 @@
 // of the possibility of those damages.
 // *********************************************************************
 
+
+// The verifier of the resolve trace written by a solver compiled with
+// VERIFY_ON. It builds, by resolution, the learned clauses that the final
+// conflict depends on and checks that resolving the final conflicting
+// clause with the antecedents of the level 0 implications gives the empty
+// clause. Both files are mapped into memory and scanned in place. Nothing
+// is recursive, so a deep proof can't overflow the stack: the learned
+// clauses are built in the order of the trace, which is a topological
+// order of the resolution DAG, by several threads, and the antecedent
+// graph is walked with explicit stacks.
+
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <vector>
 #include <set>
+#include <string>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <assert.h>
 
 using namespace std;
 
-const int WORD_LEN      = 64000;
+typedef long long long64;
 
-const int MEM_LIMIT     = 800000;
+const int MEM_LIMIT     = 800000;  // in KB of resident memory
 
 const int UNKNOWN       = 2;
 
-int _peak_mem;
+atomic<int> _peak_mem;
 bool _dump_core;
 
 double get_cpu_time(void) {
@@ -64,33 +85,14 @@ double get_cpu_time(void) {
   return res;
 }
 
-void get_line(ifstream* fs, vector<char>* buf) {
-  buf->clear();
-  buf->reserve(4096);
-  while (!fs->eof()) {
-    char ch = fs->get();
-    if (ch == '\n' || ch == '\377')
-      break;
-    if (ch == '\r')
-      continue;
-    buf->push_back(ch);
-  }
-  buf->push_back('\0');
-  return;
-}
-
-int get_token(char * & lp, char * token) {
-  char * wp = token;
-  while (*lp && ((*lp == ' ') || (*lp == '\t'))) {
-    lp++;
-  }
-  while (*lp && (*lp != ' ') && (*lp != '\t') && (*lp != '\n')) {
-    *(wp++) = *(lp++);
-  }
-  *wp = '\0';                                 // terminate string
-  return wp - token;
+double get_wall_time(void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
 }
 
+// the resident memory (KB). Not VmSize, which counts the whole mapped
+// trace and the stacks of the threads.
 int get_mem_usage(void) {
   FILE * fp;
   char buffer[128];
@@ -103,12 +105,8 @@ int get_mem_usage(void) {
     cerr << "Can't open Proc file, are you sure you are using Linux?" << endl;
     exit(1);
   }
-  while (!feof(fp)) {
-    fgets(buffer, 128, fp);
-    char * ptr = buffer;
-    get_token(ptr, token);
-    if (strcmp(token, "VmSize:") == 0) {
-      get_token(ptr, token);
+  while (fgets(buffer, 128, fp) != NULL) {
+    if (sscanf(buffer, "VmRSS: %127s", token) == 1) {
       fclose(fp);
       return atoi(token);
     }
@@ -118,19 +116,125 @@ int get_mem_usage(void) {
   return 0;
 }
 
-int my_a2i(char * str) {
+// record the peak memory usage, return true if it is over the limit.
+// Thread safe.
+bool mem_out(void) {
+  int mem = get_mem_usage();
+  int peak = _peak_mem;
+  while (mem > peak && !_peak_mem.compare_exchange_weak(peak, mem))
+    ;
+  return mem > MEM_LIMIT;
+}
+
+void check_mem_out(void) {
+  if (mem_out()) {
+    cerr << "Mem out" << endl;
+    exit(1);
+  }
+}
+
+// **Class*********************************************************************
+//
+//  Synopsis    [A file mapped into memory, read only]
+//
+//  Description [The text is [begin, end), not terminated by '\0'. The
+//               scanning functions below move a pointer through a line
+//               of it.]
+//
+// ****************************************************************************
+
+class CMappedFile {
+  private:
+    void *      _addr;
+    size_t      _size;
+
+  public:
+    const char * begin;
+    const char * end;
+    int         line_num;  // of the line being scanned, for error messages
+
+    CMappedFile(const char * filename) {
+      _addr = NULL;
+      _size = 0;
+      begin = end = NULL;
+      line_num = 0;
+      int fd = open(filename, O_RDONLY);
+      struct stat st;
+      if (fd < 0 || fstat(fd, &st) != 0) {
+        cerr << "Can't open input file " << filename << endl;
+        exit(1);
+      }
+      _size = st.st_size;
+      if (_size > 0) {
+        _addr = mmap(NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (_addr == MAP_FAILED) {
+          cerr << "Can't map input file " << filename << endl;
+          exit(1);
+        }
+        madvise(_addr, _size, MADV_SEQUENTIAL);
+        begin = (const char *) _addr;
+        end = begin + _size;
+      }
+      close(fd);
+    }
+
+    ~CMappedFile(void) {
+      if (_addr != NULL)
+        munmap(_addr, _size);
+    }
+
+    void format_error(const char * msg) {
+      cerr << "Format Error at line " << line_num << ": " << msg << endl;
+      exit(1);
+    }
+};
+
+inline bool is_blank(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+// get the next token of the line, return its length (0 at the end of
+// the line). lp is left after the token.
+int get_token(const char * & lp, const char * end, const char * & token) {
+  while (lp < end && is_blank(*lp))
+    ++lp;
+  token = lp;
+  while (lp < end && !is_blank(*lp) && *lp != '\n')
+    ++lp;
+  return lp - token;
+}
+
+// move lp to the beginning of the next line
+void next_line(const char * & lp, const char * end) {
+  while (lp < end && *lp != '\n')
+    ++lp;
+  if (lp < end)
+    ++lp;
+}
+
+bool token_is(const char * token, int len, const char * word) {
+  return len == (int) strlen(word) && strncmp(token, word, len) == 0;
+}
+
+int my_a2i(const char * str, int len) {
   int result = 0;
   bool neg = false;
-  if (str[0] == '-') {
+  const char * end = str + len;
+  if (str < end && str[0] == '-') {
     neg = true;
     ++str;
-  }
-  else if (str[0] == '+')
+  } else if (str < end && str[0] == '+') {
     ++str;
-  for (unsigned i = 0; i < strlen(str); ++i) {
-    int d = str[i] - '0';
+  }
+  if (str == end) {
+    cerr << "Abort: Unable to change an empty string into a number " << endl;
+    exit(1);
+  }
+  for (; str < end; ++str) {
+    int d = *str - '0';
     if (d < 0 || d > 9) {
-      cerr << "Abort: Unable to change " << str << " into a number " << endl;
+      cerr << "Abort: Unable to change " << string(str, end - str)
+           << " into a number " << endl;
       exit(1);
     }
     result = result * 10 + d;
@@ -140,21 +244,22 @@ int my_a2i(char * str) {
   return result;
 }
 
-class CClause {
-  public:
-    vector<int> literals;
-    vector<int> resolvents;
-    bool is_involved    : 1;
-    bool is_built       : 1;
-    bool is_needed      : 1;
-
-    CClause(void) {
-      is_involved = false;
-      is_built = false;
-      is_needed = false;
-    }
-    ~CClause(void) {}
-};
+// read the next token of the line as a number, it must be there
+int get_number(CMappedFile & f, const char * & lp) {
+  const char * token;
+  int len = get_token(lp, f.end, token);
+  if (len == 0)
+    f.format_error("number expected");
+  return my_a2i(token, len);
+}
+
+// read the next token of the line, it must be word
+void get_word(CMappedFile & f, const char * & lp, const char * word) {
+  const char * token;
+  int len = get_token(lp, f.end, token);
+  if (!token_is(token, len, word))
+    f.format_error((string(word) + " expected").c_str());
+}
 
 class CVariable {
   public:
@@ -174,44 +279,97 @@ class CVariable {
     }
 };
 
-struct cmp_var_level {
-  bool operator() (CVariable * v1, CVariable * v2) {
-    if (v1->level > v2->level)
-      return true;
-    else if (v1->level < v2->level)
-      return false;
-    else if ( (int)v1 > (int)v2)
-      return true;
-    return false;
-  }
+// the flags of a clause
+enum {
+  CLS_ROOT      = 0x1,  // the final conflict or an antecedent, kept built
+  CLS_TO_BUILD  = 0x2,  // a learned clause a root depends on
+  CLS_INVOLVED  = 0x4,  // in the implication graph of the final conflict
+  CLS_NEEDED    = 0x8   // in the resolution proof of the empty clause
 };
 
+// **Class*********************************************************************
+//
+//  Synopsis    [The clauses and the resolution DAG of the trace]
+//
+//  Description [Clause ids are those of the solver: the original clauses
+//               in the order of the CNF, then the learned clauses in the
+//               order of the trace. The literals of the original clauses
+//               and the resolvents of the learned clauses are each kept
+//               in one array, indexed by clause. A learned clause gets
+//               its literals when it is built, and loses them again when
+//               all the clauses built from it are built, unless it is a
+//               root.]
+//
+// ****************************************************************************
+
 class CDatabase {
   private:
-    int                 _current_num_clauses;
-    int                 _num_init_clauses;
+    int                 _num_init_clauses;   // by the header of the CNF
+    int                 _num_orig_clauses;   // in the CNF
     vector<CVariable>   _variables;
-    vector<CClause>     _clauses;
+    vector<int>         _orig_lits;          // of original clause i, from
+    vector<long64>      _orig_start;         // _orig_start[i] on
+    vector<int>         _resolvents;         // of learned clause k, from
+    vector<long64>      _res_start;          // _res_start[k] on
+    vector<int *>       _learned_lits;       // of learned clause k: the
+                                             // size, then the literals
+    vector<char>        _flags;              // of each clause
     int                 _conf_id;
     vector<int>         _conf_clause;
+    int                 _num_threads;
+
+    // shared by the threads that build the learned clauses
+    vector<int>         _build_order;        // the learned clauses to build
+    atomic<unsigned>    _build_next;         // the next one to take
+    atomic<char> *      _built;              // of each learned clause
+    atomic<int> *       _num_users;          // unbuilt clauses using it
+    atomic<bool>        _build_failed;
+    mutex               _error_mutex;
+    string              _error;
 
   public:
     CDatabase(void) {
       _num_init_clauses = 0;
-      _current_num_clauses = 0;
+      _num_orig_clauses = 0;
       _conf_id = -1;
+      _num_threads = 1;
+      _built = NULL;
+      _num_users = NULL;
+      _orig_start.push_back(0);
+      _res_start.push_back(0);
+    }
+
+    ~CDatabase(void) {
+      for (unsigned i = 0; i < _learned_lits.size(); ++i)
+        delete [] _learned_lits[i];
     }
 
     int & num_init_clauses(void) {
       return _num_init_clauses;
     }
 
-    vector<CVariable> & variables(void) {
-      return _variables;
+    int num_clauses(void) {
+      return _num_orig_clauses + _learned_lits.size();
+    }
+
+    bool is_learned(int cl_id) {
+      return cl_id >= _num_orig_clauses;
     }
 
-    vector<CClause> & clauses(void) {
-      return  _clauses;
+    // the literals of a clause, NULL if it is a learned clause that is
+    // not built
+    const int * literals(int cl_id, int & num_lits) {
+      if (!is_learned(cl_id)) {
+        num_lits = _orig_start[cl_id + 1] - _orig_start[cl_id];
+        return &_orig_lits[_orig_start[cl_id]];
+      }
+      int * lits = _learned_lits[cl_id - _num_orig_clauses];
+      num_lits = lits ? lits[0] : 0;
+      return lits ? lits + 1 : NULL;
+    }
+
+    void set_num_threads(int n) {
+      _num_threads = n;
     }
 
     void read_cnf(char * filename);
@@ -221,30 +379,21 @@ class CDatabase {
       assert(_variables[svar>>1].value != UNKNOWN);
       return _variables[svar>>1].value ^ (svar & 0x1);
     }
-    int add_orig_clause_by_lits(vector<int> lits);
-    int add_learned_clause_by_resolvents(vector<int> & resolvents);
+    void add_orig_clause_by_lits(vector<int> & lits);
     void set_var_number(int nvar);
     void set_init_cls_number(int n) {
       _num_init_clauses = n;
     }
     void construct_learned_clauses(void);
-    void recursive_construct_clause(int cl_id);
-    void recursive_find_involved(int cl_id);
-    int recursive_find_level(int vid);
-    void dump(void);
+    void build_learned_clauses(void);
+    bool build_clause(int cl_id, vector<signed char> & phase,
+                      vector<int> & new_cl);
+    void build_failed(const string & msg);
+    void find_involved(void);
+    void levelize(void);
+    void find_needed(void);
 };
 
-void CDatabase::dump(void) {
-  cout << "p cnf " << _variables.size() - 1 << " " << _num_init_clauses << endl;
-  for (unsigned i = 0; i < _clauses.size(); ++i) {
-    for (unsigned j = 0; j < _clauses[i].literals.size(); ++j) {
-      int lit = _clauses[i].literals[j];
-      cout << ((lit & 0x1) ? "-" : "") << (lit >> 1) << " ";
-    }
-    cout << "0" << endl;
-  }
-}
-
 void CDatabase::set_var_number(int nvar) {
   _variables.resize(nvar + 1);
   for (unsigned i = 0; i < _variables.size(); ++i) {
@@ -253,26 +402,11 @@ void CDatabase::set_var_number(int nvar) {
   }
 }
 
-void check_mem_out(void) {
-  int mem = get_mem_usage();
-  if (mem > MEM_LIMIT) {
-    cerr << "Mem out" << endl;
-    exit(1);
-  }
-  if (mem > _peak_mem)
-    _peak_mem = mem;
-}
-
-int CDatabase::add_orig_clause_by_lits(vector<int> lits) {
-  static int line_n = 0;
-  ++line_n;
+void CDatabase::add_orig_clause_by_lits(vector<int> & lits) {
   if (lits.size() == 0) {
     cerr << "Empty Clause Encountered " << endl;
     exit(1);
   }
-  int cls_id = _clauses.size();
-  _clauses.resize(_clauses.size() + 1);
-  vector<int> temp_cls;
   for (unsigned i = 0; i < lits.size(); ++i) {
     int vid = lits[i];
     int phase = 0;
@@ -286,86 +420,53 @@ int CDatabase::add_orig_clause_by_lits(vector<int> lits) {
     }
     if (_variables[vid].in_clause_phase == UNKNOWN) {
       _variables[vid].in_clause_phase = phase;
-      temp_cls.push_back(vid + vid + phase);
-//    _clauses[cls_id].my_literals.push_back(vid + vid + phase);
+      _orig_lits.push_back(vid + vid + phase);
       ++_variables[vid].num_lits[phase];
     }
     else if (_variables[vid].in_clause_phase != phase) {
-      cerr << "clause " << line_n << endl;
+      cerr << "clause " << _num_orig_clauses + 1 << endl;
       cerr << "A clause contain both literal and its negate " << endl;
       exit(1);
     }
   }
-  _clauses[cls_id].literals.resize(temp_cls.size());
-  for (unsigned i = 0; i< temp_cls.size(); ++i) {
-    _clauses[cls_id].literals[i]= temp_cls[i];
-  }
-  _clauses[cls_id].is_built = true;
-//      _clauses[cls_id].my_is_built = true;
   for (unsigned i = 0; i< lits.size(); ++i) {
     int vid = lits[i];
     if (vid < 0) vid = -vid;
     _variables[vid].in_clause_phase = UNKNOWN;
   }
-  ++_current_num_clauses;
-  if (_current_num_clauses%10 == 0)
+  _orig_start.push_back(_orig_lits.size());
+  ++_num_orig_clauses;
+  if (_num_orig_clauses % 0x10000 == 0)
     check_mem_out();
-  return cls_id;
-}
-
-int CDatabase::add_learned_clause_by_resolvents(vector<int> & resolvents) {
-  int cls_id = _clauses.size();
-  _clauses.resize(_clauses.size() + 1);
-  _clauses[cls_id].resolvents.resize(resolvents.size());
-  for (unsigned i = 0; i< resolvents.size(); ++i)
-    _clauses[cls_id].resolvents[i] = resolvents[i];
-  _clauses[cls_id].is_built = false;
-  return cls_id;
 }
 
 void CDatabase::read_cnf(char * filename) {
   cout << "Read in original clauses ... ";
-  ifstream in_file(filename);
-  if (!in_file) {
-    cerr << "Can't open input CNF file " << filename << endl;
-    exit(1);
-  }
-  vector<char> buffer;
+  CMappedFile in_file(filename);
   vector<int> literals;
   bool header_encountered = false;
-  char token[WORD_LEN];
-  while (!in_file.eof()) {
-    get_line(&in_file, &buffer);
-    char * ptr = &(*buffer.begin());
-    if (get_token(ptr, token)) {
-      if (strcmp(token, "c") == 0)
-        continue;
-      else if (strcmp(token, "p") == 0) {
-        get_token(ptr, token);
-        if (strcmp(token, "cnf") != 0) {
-          cerr << "Format Error, p cnf NumVar NumCls " << endl;
-          exit(1);
-        }
-        get_token(ptr, token);
-        int nvar = my_a2i(token);
-        set_var_number(nvar);
-        get_token(ptr, token);
-        int ncls = my_a2i(token);
-        set_init_cls_number(ncls);
-        header_encountered = true;
-        continue;
-      } else {
-        int lit = my_a2i(token);
-        if (lit != 0) {
-          literals.push_back(lit);
-        } else {
-          add_orig_clause_by_lits(literals);
-          literals.clear();
-        }
-      }
+  const char * lp = in_file.begin;
+  const char * token;
+  while (lp < in_file.end) {
+    ++in_file.line_num;
+    int len = get_token(lp, in_file.end, token);
+    if (token_is(token, len, "c")) {
+      next_line(lp, in_file.end);
+      continue;
+    } else if (token_is(token, len, "p")) {
+      get_word(in_file, lp, "cnf");
+      int nvar = get_number(in_file, lp);
+      set_var_number(nvar);
+      int ncls = get_number(in_file, lp);
+      set_init_cls_number(ncls);
+      header_encountered = true;
+      next_line(lp, in_file.end);
+      continue;
     }
-    while (get_token(ptr, token)) {
-      int lit = my_a2i(token);
+    for (; len > 0; len = get_token(lp, in_file.end, token)) {
+      if (!header_encountered)
+        in_file.format_error("p cnf NumVar NumCls expected");
+      int lit = my_a2i(token, len);
       if (lit != 0) {
         literals.push_back(lit);
       } else {
@@ -373,148 +474,324 @@ void CDatabase::read_cnf(char * filename) {
         literals.clear();
       }
     }
+    next_line(lp, in_file.end);
   }
   if (!literals.empty()) {
     cerr << "Trailing numbers without termination " << endl;
     exit(1);
   }
-  if (clauses().size() != (unsigned)num_init_clauses())
+  if (_num_orig_clauses != num_init_clauses())
     cerr << "WARNING : Clause count inconsistant with the header " << endl;
   cout << num_init_clauses() << " Clauses " << endl;
 }
 
-void CDatabase::recursive_find_involved(int cl_id) {
-  if (_clauses[cl_id].is_involved == true)
-    return;
-  _clauses[cl_id].is_involved = true;
-
-  recursive_construct_clause(cl_id);
-
-  int num_1 = 0;
-  for (unsigned i = 0; i < _clauses[cl_id].literals.size(); ++i) {
-    int lit = _clauses[cl_id].literals[i];
-    int vid = (lit>>1);
-    int sign = (lit & 0x1);
-    assert(_variables[vid].value != UNKNOWN);
-    if ((_variables[vid].value == 1 && sign == 0) ||
-      (_variables[vid].value == 0 && sign == 1)) {
-      if (num_1 == 0) {
-        ++num_1;
-      } else {
-        cerr << "Clause " << cl_id << " has more than one value 1 literals "
-             << endl;
-        exit(1);
-      }
-    } else {  // literal value 0, so seek its antecedent
-      int ante = _variables[vid].antecedent;
-      recursive_find_involved(ante);
-    }
+void CDatabase::build_failed(const string & msg) {
+  lock_guard<mutex> lock(_error_mutex);
+  if (!_build_failed) {
+    _error = msg;
+    _build_failed = true;
   }
 }
 
-void CDatabase::recursive_construct_clause(int cl_id) {
-  CClause & cl = _clauses[cl_id];
-  if (cl.is_built == true)
-    return;
-
-  assert(cl.resolvents.size() > 1);
-
-  // I have to construct them first because of recursion may
-  // mess up with the in_clause_signs.
-  for (unsigned i = 0; i < cl.resolvents.size(); ++i) {
-    _clauses[cl.resolvents[i]].is_needed = true;
-    recursive_construct_clause(cl.resolvents[i]);
+// build a learned clause from its resolvents, which must be built. phase
+// is indexed by variable and must be all UNKNOWN, as it is left.
+bool CDatabase::build_clause(int cl_id, vector<signed char> & phase,
+                             vector<int> & new_cl) {
+  int k = cl_id - _num_orig_clauses;
+  long64 begin = _res_start[k];
+  long64 end = _res_start[k + 1];
+  if (end - begin < 2) {
+    ostringstream msg;
+    msg << "Clause " << cl_id << " has less than two resolvents";
+    build_failed(msg.str());
+    return false;
   }
 
-//      cout << "Constructing clause " << cl_id << endl;
-  vector<int> literals;
-
   // initialize
-  int cl1 = cl.resolvents[0];
-  assert(_clauses[cl1].is_built);
-  for (unsigned i = 0; i < _clauses[cl1].literals.size(); ++i) {
-    int lit = _clauses[cl1].literals[i];
-    int vid = (lit >> 0x1);
-    int sign = (lit & 0x1);
-    assert(_variables[vid].in_clause_phase == UNKNOWN);
-    _variables[vid].in_clause_phase = sign;
-    literals.push_back(lit);
+  new_cl.clear();
+  int n;
+  const int * lits = literals(_resolvents[begin], n);
+  assert(lits != NULL);
+  for (int i = 0; i < n; ++i) {
+    int lit = lits[i];
+    assert(phase[lit >> 1] == UNKNOWN);
+    phase[lit >> 1] = lit & 0x1;
+    new_cl.push_back(lit);
   }
 
-  for (unsigned i = 1; i < cl.resolvents.size(); ++i) {
+  for (long64 r = begin + 1; r < end; ++r) {
     int distance = 0;
-    int cl1 = cl.resolvents[i];
-    assert(_clauses[cl1].is_built);
-    for (unsigned j = 0; j < _clauses[cl1].literals.size(); ++j) {
-      int lit = _clauses[cl1].literals[j];
+    lits = literals(_resolvents[r], n);
+    assert(lits != NULL);
+    for (int j = 0; j < n; ++j) {
+      int lit = lits[j];
       int vid = (lit >> 0x1);
       int sign = (lit & 0x1);
-      if (_variables[vid].in_clause_phase == UNKNOWN) {
-        _variables[vid].in_clause_phase = sign;
-        literals.push_back(lit);
-      }
-      else if (_variables[vid].in_clause_phase != sign) {
+      if (phase[vid] == UNKNOWN) {
+        phase[vid] = sign;
+        new_cl.push_back(lit);
+      } else if (phase[vid] != sign) {
         // distance 1 literal
         ++distance;
-        _variables[vid].in_clause_phase = UNKNOWN;
+        phase[vid] = UNKNOWN;
       }
     }
     if (distance != 1) {
-      cerr << "Resolve between two clauses with distance larger than 1" << endl;
-      cerr << "The resulting clause is " << cl_id << endl;
-      cerr << "Starting clause is " << cl.resolvents[0] << endl;
-      cerr << "One of the clause involved is " << cl1 << endl;
-      exit(1);
+      for (unsigned i = 0; i < new_cl.size(); ++i)
+        phase[new_cl[i] >> 1] = UNKNOWN;
+      ostringstream msg;
+      msg << "Resolve between two clauses with distance larger than 1" << endl
+          << "The resulting clause is " << cl_id << endl
+          << "Starting clause is " << _resolvents[begin] << endl
+          << "One of the clause involved is " << _resolvents[r];
+      build_failed(msg.str());
+      return false;
     }
   }
-  vector<int> temp_cls;
-  for (unsigned i = 0; i < literals.size(); ++i) {
-    int lit = literals[i];
+  unsigned num_lits = 0;
+  for (unsigned i = 0; i < new_cl.size(); ++i) {
+    int lit = new_cl[i];
     int vid = (lit >> 0x1);
-    int sign = (lit & 0x1);
-    if (_variables[vid].in_clause_phase == UNKNOWN)
+    if (phase[vid] == UNKNOWN)
       continue;
-    assert(_variables[vid].in_clause_phase == sign);
-    _variables[vid].in_clause_phase = UNKNOWN;
-    temp_cls.push_back(lit);
-  }
-  cl.literals.resize(temp_cls.size());
-  for (unsigned i = 0; i < temp_cls.size(); ++i)
-    cl.literals[i] = temp_cls[i];
-
-//      ::sort(cl.literals.begin(), cl.literals.end());
-//      assert(cl.literals.size()== cl.my_literals.size());
-//      for (unsigned i=0; i< cl.literals.size(); ++i)
-//        assert(cl.literals[i] == cl.my_literals[i]);
-  cl.is_built = true;
-  ++_current_num_clauses;
-  if (_current_num_clauses%10 == 0)
-    check_mem_out();
+    assert(phase[vid] == (lit & 0x1));
+    phase[vid] = UNKNOWN;
+    new_cl[num_lits++] = lit;
+  }
+  int * cl_lits = new int[num_lits + 1];
+  cl_lits[0] = num_lits;
+  for (unsigned i = 0; i < num_lits; ++i)
+    cl_lits[i + 1] = new_cl[i];
+  _learned_lits[k] = cl_lits;
+  return true;
+}
+
+// the work of a thread: take the learned clauses to build in the order of
+// the trace. The resolvents of a clause come before it, so the first
+// clause not yet built can always be built and the waiting below ends.
+void CDatabase::build_learned_clauses(void) {
+  vector<signed char> phase(_variables.size(), UNKNOWN);
+  vector<int> new_cl;
+  unsigned num_built = 0;
+  while (!_build_failed) {
+    unsigned next = _build_next++;
+    if (next >= _build_order.size())
+      break;
+    int cl_id = _build_order[next];
+    int k = cl_id - _num_orig_clauses;
+    for (long64 r = _res_start[k]; r < _res_start[k + 1]; ++r) {
+      int res = _resolvents[r];
+      if (!is_learned(res))
+        continue;
+      while (!_built[res - _num_orig_clauses].load(memory_order_acquire)) {
+        if (_build_failed)
+          return;
+        this_thread::yield();
+      }
+    }
+    if (!build_clause(cl_id, phase, new_cl))
+      return;
+    _built[k].store(true, memory_order_release);
+
+    for (long64 r = _res_start[k]; r < _res_start[k + 1]; ++r) {
+      int res = _resolvents[r];
+      if (!is_learned(res) || (_flags[res] & CLS_ROOT))
+        continue;
+      if (--_num_users[res - _num_orig_clauses] == 0) {
+        delete [] _learned_lits[res - _num_orig_clauses];
+        _learned_lits[res - _num_orig_clauses] = NULL;
+      }
+    }
+    if (++num_built % 0x400 == 0 && mem_out()) {
+      build_failed("Mem out");
+      return;
+    }
+  }
+}
+
+// build the final conflicting clause and all the antecedents (and what they
+// are resolved from). That may build a few antecedents that are not
+// involved in the final conflict, but it allows building all of them at
+// once in parallel, while the involved ones are only known once built.
+void CDatabase::construct_learned_clauses(void) {
+  vector<int> stack;
+  stack.push_back(_conf_id);
+  for (unsigned i = 1; i < _variables.size(); ++i)
+    if (_variables[i].value != UNKNOWN && _variables[i].antecedent != -1)
+      stack.push_back(_variables[i].antecedent);
+  for (unsigned i = 0; i < stack.size(); ++i)
+    _flags[stack[i]] |= CLS_ROOT;
+
+  int num_learned = _learned_lits.size();
+  _num_users = new atomic<int>[num_learned];
+  _built = new atomic<char>[num_learned];
+  for (int k = 0; k < num_learned; ++k) {
+    _num_users[k] = 0;
+    _built[k] = false;
+  }
+  while (!stack.empty()) {
+    int cl_id = stack.back();
+    stack.pop_back();
+    if (!is_learned(cl_id) || (_flags[cl_id] & CLS_TO_BUILD))
+      continue;
+    _flags[cl_id] |= CLS_TO_BUILD;
+    int k = cl_id - _num_orig_clauses;
+    for (long64 r = _res_start[k]; r < _res_start[k + 1]; ++r) {
+      int res = _resolvents[r];
+      if (is_learned(res))
+        ++_num_users[res - _num_orig_clauses];
+      stack.push_back(res);
+    }
+  }
+  for (int cl_id = _num_orig_clauses; cl_id < num_clauses(); ++cl_id)
+    if (_flags[cl_id] & CLS_TO_BUILD)
+      _build_order.push_back(cl_id);
+
+  _build_next = 0;
+  _build_failed = false;
+  int num_threads = _num_threads;
+  if (num_threads > (int) _build_order.size())
+    num_threads = _build_order.size();
+  if (num_threads <= 1) {
+    build_learned_clauses();
+  } else {
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+      threads.push_back(thread(&CDatabase::build_learned_clauses, this));
+    for (int t = 0; t < num_threads; ++t)
+      threads[t].join();
+  }
+  delete [] _num_users;
+  delete [] _built;
+  _num_users = NULL;
+  _built = NULL;
+  if (_build_failed) {
+    cerr << _error << endl;
+    exit(1);
+  }
+  cout << "Num. Learned Clause:\t\t\t" << num_learned << endl
+       << "Num. Clause Built:\t\t\t" << _build_order.size() << endl
+       << "Build Threads:\t\t\t\t" << (num_threads > 1 ? num_threads : 1)
+       << endl;
+}
+
+// mark the clauses in the implication graph of the final conflict: it and
+// the antecedents of the variables of its literals, and so on
+void CDatabase::find_involved(void) {
+  vector<int> stack;
+  _flags[_conf_id] |= CLS_INVOLVED;
+  stack.push_back(_conf_id);
+  while (!stack.empty()) {
+    int cl_id = stack.back();
+    stack.pop_back();
+    int n;
+    const int * lits = literals(cl_id, n);
+    assert(lits != NULL);
+    int num_1 = 0;
+    for (int i = 0; i < n; ++i) {
+      int vid = (lits[i] >> 1);
+      if (_variables[vid].value == UNKNOWN) {
+        cerr << "Clause " << cl_id << " has the unassigned variable " << vid
+             << endl;
+        exit(1);
+      }
+      if (lit_value(lits[i]) == 1) {
+        if (num_1 == 0) {
+          ++num_1;
+        } else {
+          cerr << "Clause " << cl_id << " has more than one value 1 literals "
+               << endl;
+          exit(1);
+        }
+      } else {  // literal value 0, so seek its antecedent
+        int ante = _variables[vid].antecedent;
+        if (ante == -1) {
+          cerr << "Variable " << vid << " has an NULL antecedent " << endl;
+          exit(1);
+        }
+        if (!(_flags[ante] & CLS_INVOLVED)) {
+          _flags[ante] |= CLS_INVOLVED;
+          stack.push_back(ante);
+        }
+      }
+    }
+  }
 }
 
-int CDatabase::recursive_find_level(int vid) {
-  int ante = _variables[vid].antecedent;
-  assert(_variables[vid].value != UNKNOWN);
-  assert(_variables[vid].antecedent != -1);
-  assert(_clauses[ante].is_involved);
-  if (_variables[vid].level != -1)
-    return _variables[vid].level;
-  int level = -1;
-  for (unsigned i = 0; i <_clauses[ante].literals.size(); ++i) {
-    int v = (_clauses[ante].literals[i] >> 1);
-    int s = (_clauses[ante].literals[i] & 0x1);
-    if (v == vid) {
-      assert(_variables[v].value != s);
+// the level of a variable is one more than the largest level of the other
+// variables of its antecedent, 0 if there are none. Computed in post
+// order with an explicit stack, where level -2 marks the variables on it.
+void CDatabase::levelize(void) {
+  vector<int> stack;
+  for (unsigned i = 1; i < _variables.size(); ++i) {
+    int cl_id = _variables[i].antecedent;
+    if (_variables[i].value == UNKNOWN || cl_id == -1 ||
+        !(_flags[cl_id] & CLS_INVOLVED) || _variables[i].level != -1)
       continue;
-    } else {
-      assert(_variables[v].value == s);
-      int l = recursive_find_level(v);
-      if (level < l )
-        level = l;
+    stack.push_back(i);
+    while (!stack.empty()) {
+      int vid = stack.back();
+      CVariable & var = _variables[vid];
+      if (var.level >= 0) {
+        stack.pop_back();
+        continue;
+      }
+      bool first_visit = (var.level == -1);
+      var.level = -2;
+      int n;
+      const int * lits = literals(var.antecedent, n);
+      assert(lits != NULL);
+      int level = -1;
+      for (int j = 0; j < n; ++j) {
+        int v = (lits[j] >> 1);
+        if (v == vid)
+          continue;
+        if (lit_value(lits[j]) != 0) {
+          cerr << "The antecedent of variable " << vid
+               << " is not really an antecedent " << endl;
+          exit(1);
+        }
+        if (first_visit) {
+          if (_variables[v].level == -2) {
+            cerr << "Variable " << vid << " implies itself " << endl;
+            exit(1);
+          }
+          if (_variables[v].level == -1)
+            stack.push_back(v);
+        } else if (level < _variables[v].level) {
+          level = _variables[v].level;
+        }
+      }
+      if (!first_visit) {
+        var.level = level + 1;
+        stack.pop_back();
+      }
+    }
+  }
+}
+
+// mark the clauses in the resolution proof of the empty clause: the final
+// conflicting clause, the antecedents resolved with it and, for the
+// learned ones among them, the clauses they are resolved from
+void CDatabase::find_needed(void) {
+  vector<int> stack;
+  for (int cl_id = 0; cl_id < num_clauses(); ++cl_id)
+    if (_flags[cl_id] & CLS_NEEDED)
+      stack.push_back(cl_id);
+  while (!stack.empty()) {
+    int cl_id = stack.back();
+    stack.pop_back();
+    if (!is_learned(cl_id))
+      continue;
+    int k = cl_id - _num_orig_clauses;
+    for (long64 r = _res_start[k]; r < _res_start[k + 1]; ++r) {
+      int res = _resolvents[r];
+      if (!(_flags[res] & CLS_NEEDED)) {
+        _flags[res] |= CLS_NEEDED;
+        stack.push_back(res);
+      }
     }
   }
-  _variables[vid].level = level + 1;
-  return level + 1;
 }
 
 bool CDatabase::real_verify(void) {
@@ -524,8 +801,6 @@ bool CDatabase::real_verify(void) {
     if (_variables[i].value != UNKNOWN && _variables[i].antecedent == -1) {
       if ((_variables[i].num_lits[0] == 0 && _variables[i].value == 0) ||
         (_variables[i].num_lits[1] == 0 && _variables[i].value == 1)) {
-//      cout << "Variable " << i << " is assigned " << _variables[i].value
-//      << " because it is pure literal. " << endl;
       } else {
         cerr << "Don't know why variable " << i << " is assigned "
              << _variables[i].value << " for no reasons" << endl;
@@ -533,35 +808,28 @@ bool CDatabase::real_verify(void) {
       }
     }
   }
-  // 2. Construct the final conflicting clause if needed and find all
-  // the clauses that are involved in making it conflicting
+  // 2. Construct the final conflicting clause and the antecedents, and
+  // find all the clauses that are involved in making it conflicting
   cout << "Begin constructing all involved clauses " << endl;
-  _clauses[_conf_id].is_needed = true;
-  recursive_find_involved(_conf_id);
-  int count = 0;
-  for (unsigned i = num_init_clauses(); i< _clauses.size(); ++i)
-    if (_clauses[i].is_built)
-      ++count;
-  cout << "Num. Learned Clause:\t\t\t" << _clauses.size() - num_init_clauses()
-       << endl
-       << "Num. Clause Built:\t\t\t" << count << endl
-       << "Constructed all involved clauses " << endl;
+  _flags.resize(num_clauses(), 0);
+  construct_learned_clauses();
+  find_involved();
+  cout << "Constructed all involved clauses " << endl;
 
   // 2.5. Verify the literals in the CONF clause
   // comments this out if it gives error because you give the wrong
   // CONF clause literals.
-  assert(_clauses[_conf_id].is_built);
-  assert(_clauses[_conf_id].is_involved);
-  bool _found;
+  int num_conf_lits;
+  const int * conf_lits = literals(_conf_id, num_conf_lits);
   for (unsigned i = 0; i <_conf_clause.size(); ++i) {
-    _found = false;
-    for (unsigned j = 0; j <_clauses[_conf_id].literals.size(); ++j) {
-      if (_conf_clause[i] == _clauses[_conf_id].literals[j]) {
-        _found = true;
+    bool found = false;
+    for (int j = 0; j < num_conf_lits; ++j) {
+      if (_conf_clause[i] == conf_lits[j]) {
+        found = true;
         break;
       }
     }
-    if (!_found) {
+    if (!found) {
       cerr << "The conflict clause in trace can't be verified! " << endl;
       cerr << "Literal " << _conf_clause[i] << " is not found." << endl;
     }
@@ -570,48 +838,37 @@ bool CDatabase::real_verify(void) {
 
   // 3. Levelize the variables that are decided at dlevel 0
   cout << "Levelize variables...";
-  for (unsigned i = 1; i < _variables.size(); ++i) {
-    int cl_id = _variables[i].antecedent;
-    if (_variables[i].value != UNKNOWN &&  cl_id != -1) {
-      if (_clauses[cl_id].is_involved) {
-           recursive_find_level(i);
-//         int level = recursive_find_level(i);
-//         cout << "Var: " << i << " level " << level << endl;
-      }
-    }
-  }
+  levelize();
   cout << "finished"<< endl;
-  // 4. Can we construct an empty clause?
+
+  // 4. Can we construct an empty clause? Resolve the variables from the
+  // highest level down, i.e. each after all the variables it implies.
   cout << "Begin Resolution..." ;
-  set<CVariable *, cmp_var_level> clause_lits;
-  for (unsigned i = 0; i< _clauses[_conf_id].literals.size(); ++i) {
-    assert(lit_value(_clauses[_conf_id].literals[i]) == 0);
-    int vid = (_clauses[_conf_id].literals[i] >> 1);
-    clause_lits.insert(&_variables[vid]);
+  set<pair<int, int>, greater<pair<int, int> > > clause_lits;
+  for (int i = 0; i < num_conf_lits; ++i) {
+    if (lit_value(conf_lits[i]) != 0) {
+      cerr << "The final conflicting clause is not conflicting " << endl;
+      exit(1);
+    }
+    int vid = (conf_lits[i] >> 1);
+    clause_lits.insert(make_pair(_variables[vid].level, vid));
   }
-  assert(clause_lits.size() == _clauses[_conf_id].literals.size());
+  _flags[_conf_id] |= CLS_NEEDED;
 
   while (!clause_lits.empty()) {
-//    for (set<CVariable *, cmp_var_level>::iterator itr = clause_lits.begin();
-//         itr != clause_lits.end(); ++itr) {
-//      int vid = (*itr) - &_variables[0];
-//      cout << vid << "(" << (*itr)->level << ") ";
-//    }
-//    cout << endl;
-
-    int vid = (*clause_lits.begin() - &_variables[0]);
+    int vid = clause_lits.begin()->second;
     int ante = _variables[vid].antecedent;
     if (ante == -1) {
       cerr << "Variable " << vid << " has an NULL antecedent ";
       exit(1);
     }
-    _clauses[ante].is_needed = true;
+    _flags[ante] |= CLS_NEEDED;
     clause_lits.erase(clause_lits.begin());
-    _variables[vid].in_clause_phase = 1;
-    CClause & cl = _clauses[ante];
+    int n;
+    const int * lits = literals(ante, n);
     int distance = 0;
-    for (unsigned i = 0; i< cl.literals.size(); ++i) {
-      int l = cl.literals[i];
+    for (int i = 0; i < n; ++i) {
+      int l = lits[i];
       int v = (l>>1);
       assert(_variables[v].value != UNKNOWN);
       if (lit_value(l) == 1) {
@@ -624,19 +881,23 @@ bool CDatabase::real_verify(void) {
           ++distance;
       }
       else
-        clause_lits.insert(&_variables[v]);
+        clause_lits.insert(make_pair(_variables[v].level, v));
     }
     assert(distance == 1);
   }
   cout << " Empty clause generated." << endl;
+  mem_out();
   cout << "Mem Usage :\t\t\t\t" << get_mem_usage()<< endl;
+  find_needed();
   int needed_cls_count = 0;
   int needed_var_count = 0;
-  for (int i = 0; i < num_init_clauses(); ++i) {
-    if (_clauses[i].is_needed == true) {
+  for (int i = 0; i < _num_orig_clauses; ++i) {
+    if (_flags[i] & CLS_NEEDED) {
       ++needed_cls_count;
-      for (unsigned j = 0; j < _clauses[i].literals.size(); ++j) {
-        int vid = (_clauses[i].literals[j] >> 1);
+      int n;
+      const int * lits = literals(i, n);
+      for (int j = 0; j < n; ++j) {
+        int vid = (lits[j] >> 1);
         if (_variables[vid].is_needed == false) {
           ++needed_var_count;
           _variables[vid].is_needed = true;
@@ -649,10 +910,6 @@ bool CDatabase::real_verify(void) {
   cout << "Total Variable count:\t\t\t" << _variables.size()-1 << endl;
   cout << "Variables involved in Empty:\t\t" << needed_var_count << endl;
 
-  for (unsigned i = 0; i< _clauses.size(); ++i) {
-    if (_clauses[i].is_built)
-      assert(_clauses[i].is_needed || i < (unsigned)num_init_clauses());
-  }
   if (_dump_core == true) {
     cout << "Unsat Core dumped:\t\t\tunsat_core.cnf" << endl;
     ofstream dump("unsat_core.cnf");
@@ -668,13 +925,13 @@ bool CDatabase::real_verify(void) {
     }
     dump << endl;
     dump << "p cnf " << _variables.size()-1 << " " << needed_cls_count << endl;
-    for (int i = 0; i < num_init_clauses(); ++i) {
-      if (_clauses[i].is_needed) {
+    for (int i = 0; i < _num_orig_clauses; ++i) {
+      if (_flags[i] & CLS_NEEDED) {
         dump << "c Original Cls ID: " << i << endl;
-        for (unsigned j = 0; j < _clauses[i].literals.size(); ++j) {
-          dump << ((_clauses[i].literals[j] & 0x1)?" -":" ")
-               << (_clauses[i].literals[j] >> 1);
-        }
+        int n;
+        const int * lits = literals(i, n);
+        for (int j = 0; j < n; ++j)
+          dump << ((lits[j] & 0x1)?" -":" ") << (lits[j] >> 1);
         dump << " 0" << endl;
       }
     }
@@ -683,79 +940,79 @@ bool CDatabase::real_verify(void) {
 }
 
 bool CDatabase::verify(char * filename) {
-  vector<char> buffer;
-  char token[WORD_LEN];
-
-  ifstream in_file(filename);
-  if (!in_file) {
-    cerr << "Can't open input CNF file " << filename << endl;
-    exit(1);
-  }
-
-  while (!in_file.eof()) {
-    get_line(&in_file, &buffer);
-    char * ptr = &(*buffer.begin());
-    get_token(ptr, token);
-    if (strcmp(token, "CL:") == 0) {
-      vector<int> resolvents;
-
-      get_token(ptr, token);
-      int cl_id = my_a2i(token);
-
-      get_token(ptr, token);
-      assert(strcmp(token, "<=") == 0);
-
-      while (get_token(ptr, token)) {
-        int r = my_a2i(token);
-        resolvents.push_back(r);
+  CMappedFile in_file(filename);
+  const char * lp = in_file.begin;
+  const char * token;
+  while (lp < in_file.end) {
+    ++in_file.line_num;
+    int len = get_token(lp, in_file.end, token);
+    if (token_is(token, len, "CL:")) {
+      int cl_id = get_number(in_file, lp);
+      if (cl_id != num_clauses())
+        in_file.format_error("learned clauses out of order");
+      get_word(in_file, lp, "<=");
+      while ((len = get_token(lp, in_file.end, token)) > 0) {
+        int r = my_a2i(token, len);
+        if (r < 0 || r >= cl_id)
+          in_file.format_error("resolvent out of range");
+        _resolvents.push_back(r);
       }
-      int c = add_learned_clause_by_resolvents(resolvents);
-      assert(c == cl_id);
+      _res_start.push_back(_resolvents.size());
+      _learned_lits.push_back(NULL);
     }
-    else if (strcmp(token, "VAR:") == 0) {
-      get_token(ptr, token);
-      int vid = my_a2i(token);
+    else if (token_is(token, len, "VAR:")) {
+      int vid = get_number(in_file, lp);
+      if (vid <= 0 || vid >= (int) _variables.size())
+        in_file.format_error("variable out of range");
 
-      get_token(ptr, token);
-      assert(strcmp(token, "L:") == 0);
-      get_token(ptr, token);  // skip the level
+      get_word(in_file, lp, "L:");
+      get_number(in_file, lp);  // skip the level
 
-      get_token(ptr, token);
-      assert(strcmp(token, "V:") == 0);
-      get_token(ptr, token);
-      int value = my_a2i(token);
-      assert(value == 1 || value == 0);
+      get_word(in_file, lp, "V:");
+      int value = get_number(in_file, lp);
+      if (value != 1 && value != 0)
+        in_file.format_error("value must be 0 or 1");
 
-      get_token(ptr, token);
-      assert(strcmp(token, "A:") == 0);
-      get_token(ptr, token);
-      int ante = my_a2i(token);
+      get_word(in_file, lp, "A:");
+      int ante = get_number(in_file, lp);
 
-      get_token(ptr, token);
-      assert(strcmp(token, "Lits:") == 0);
+      get_word(in_file, lp, "Lits:");
 
       _variables[vid].value = value;
       _variables[vid].antecedent = ante;
     }
-    else if (strcmp(token, "CONF:") == 0) {
-      get_token(ptr, token);
-      _conf_id = my_a2i(token);
+    else if (token_is(token, len, "CONF:")) {
+      _conf_id = get_number(in_file, lp);
 
-      get_token(ptr, token);
-      assert(strcmp(token, "==") == 0);
+      get_word(in_file, lp, "==");
 
-      while (get_token(ptr, token)) {
-        int lit = my_a2i(token);
-        assert(lit > 0);
-        assert((lit>>1) < (int)_variables.size());
+      _conf_clause.clear();
+      while ((len = get_token(lp, in_file.end, token)) > 0) {
+        int lit = my_a2i(token, len);
+        if (lit <= 0 || (lit>>1) >= (int)_variables.size())
+          in_file.format_error("literal out of range");
         _conf_clause.push_back(lit);
       }
     }
+    next_line(lp, in_file.end);
   }
   if (_conf_id == -1) {
     cerr << "No final conflicting clause defined " << endl;
     exit(1);
   }
+  if (_conf_id >= num_clauses()) {
+    cerr << "The final conflicting clause " << _conf_id << " is not defined "
+         << endl;
+    exit(1);
+  }
+  for (unsigned i = 1; i < _variables.size(); ++i) {
+    if (_variables[i].antecedent < -1 ||
+        _variables[i].antecedent >= num_clauses()) {
+      cerr << "The antecedent of variable " << i << " is not defined " << endl;
+      exit(1);
+    }
+  }
+  mem_out();
   cout << "Mem Usage After Readin file:\t\t" << get_mem_usage() << endl;
   return real_verify();
 }
@@ -764,22 +1021,27 @@ int main(int argc, char** argv) {
   cout << "ZVerify SAT Solver Verifier" << endl;
   cout << "Copyright Princeton University, 2003-2004. All Right Reseverd."
        << endl;
-  if (argc != 3 && argc !=4) {
-    cerr << "Usage: " << argv[0] << " CNF_File Dump_File [-core]" << endl
-       << "-core: dump the unsat core " << endl;
+  int num_threads = thread::hardware_concurrency();
+  _dump_core = false;
+  bool args_ok = (argc >= 3);
+  for (int i = 3; i < argc && args_ok; ++i) {
+    if (strcmp(argv[i], "-core") == 0)
+      _dump_core = true;
+    else if (sscanf(argv[i], "-threads=%d", &num_threads) != 1 ||
+             num_threads < 1)
+      args_ok = false;
+  }
+  if (!args_ok) {
+    cerr << "Usage: " << argv[0] << " CNF_File Dump_File [-core] [-threads=n]"
+         << endl
+         << "-core: dump the unsat core " << endl
+         << "-threads=n: build the learned clauses in n threads (default: "
+         << "the number of processors)" << endl;
     cerr << endl;
     exit(1);
   }
-  if (argc == 3) {
-    _dump_core = false;
-  } else {
-    assert(argc == 4);
-    if (strcmp(argv[3], "-core") != 0) {
-      cerr << "Must use -core as the third parameter" << endl;
-      exit(1);
-    }
-    _dump_core = true;
-  }
+  if (num_threads < 1)
+    num_threads = 1;
   cout << "COMMAND LINE: ";
   for (int i = 0; i < argc; ++i)
     cout << argv[i] << " ";
@@ -787,11 +1049,16 @@ int main(int argc, char** argv) {
 
   _peak_mem = get_mem_usage();
   CDatabase dbase;
+  dbase.set_num_threads(num_threads);
   double begin_time = get_cpu_time();
+  double begin_wall_time = get_wall_time();
   dbase.read_cnf(argv[1]);
   if (dbase.verify(argv[2]) == true) {
     double end_time = get_cpu_time();
+    double end_wall_time = get_wall_time();
+    mem_out();
     cout << "CPU Time:\t\t\t\t" << end_time - begin_time << endl;
+    cout << "Wall Time:\t\t\t\t" << end_wall_time - begin_wall_time << endl;
     cout << "Peak Mem Usage:\t\t\t\t" << _peak_mem << endl;
     cout << "Verification Successful " << endl;
   } else {